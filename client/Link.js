@@ -0,0 +1,379 @@
+/**
+ *  Link.js
+ *
+ *  Encodes the command list from SVG_Parser into the binary frames the
+ *  XY-Plotter takes in (see src/Project/Link.h). Shapes are packed into as
+ *  few frames as they fit in, and each frame is acknowledged once.
+ *
+ *  Frame (little endian):
+ *
+ *      0x7E seq len payload crc(uint16)
+ *
+ *      seq      Frame number (mod 256)
+ *      len      Payload bytes (1 to 48)
+ *      payload  Records, a type byte and int16 values
+ *                   1 Circle         cx cy r
+ *                   2 Ellipse        cx cy a b
+ *                   3 Bezier         p0 p1 p2 p3 (x y each)
+ *                   4 Polygon        n (uint8) then n points (x y each)
+ *                   5 Ellipse        cx cy a b origin.x origin.y angle
+ *                   6 Feed speed     start speed accel
+ *                   7 Rapid speed    start speed accel
+ *                   8 Polyline       n (uint8) then the first point (x y) and
+ *                                    n bytes of zigzag varint dx dy for each
+ *                                    point after it
+ *                 255 End            the list of shapes is complete
+ *      crc      CRC-16/XMODEM of seq, len and payload
+ *
+ *  Any 0x7E or 0x7D after the start is sent as 0x7D then the byte XOR 0x20,
+ *  so a start only ever begins a frame.
+ *
+ *  The plotter replies ';ack seq room;' once every frame up to seq is in,
+ *  with room bytes of its shape table free for the frames after it, or
+ *  ';nak seq;' if a frame was corrupt or lost (send again from seq, the
+ *  plotter naks every frame after it until it comes). A Sender keeps
+ *  as many frames in flight as that room allows, so the line is not left
+ *  idle waiting on each ack. The plotter never gives more room than its
+ *  receive ring holds, and a frame takes its bytes on the wire from the room
+ *  when that is more, so frames in flight are never lost to a full ring.
+ *
+ *  @author Drew Sommer
+ *  @version 1.3.0
+ *  @license MIT (https://mit-license.org)
+ */
+const START   = 0x7E, // First byte of a frame (never sent in text)
+      ESCAPE  = 0x7D, // Sent before a START or ESCAPE in a frame
+      FLIP    = 0x20, // XOR for the byte after an ESCAPE
+      PAYLOAD = 48,   // Most payload bytes in a frame
+      END     = 0xFF; // Record for the end of the list
+
+// Record types for the command list shape letters
+const TYPES = { C: 1, E: 2, B: 3, P: 4, F: 6, R: 7 },
+      ROTATED  = 5, // Ellipse with a rotation
+      POLYLINE = 8; // Polygon sent as deltas
+
+// Bytes of a record by type, polygons are 2 and 4 a point
+const SIZES = { 1: 7, 2: 9, 3: 17, 5: 15, 6: 7, 7: 7 };
+
+// Most points of a polygon record, longer polygons are split
+const POINTS = Math.floor((PAYLOAD - 2) / 4);
+
+// Most frames in flight, so seq (mod 256) never refers to two of them
+const WINDOW = 128;
+
+// Milliseconds without an ack before the frames in flight are sent again.
+// The plotter reads while it draws, long shapes included, but not while it
+// homes or the pen is set, and frames sent again then would overflow its
+// receive ring. Corrupt and lost frames are asked for again sooner, with a
+// nak (a lost one as soon as a frame after it comes in)
+const TIMEOUT = 10000;
+
+/**
+ * Add a byte to a CRC-16/XMODEM (poly 0x1021, starts at 0)
+ * @param  {Number} crc  CRC so far
+ * @param  {Number} byte Byte
+ * @return {Number}      CRC
+ */
+function crc(crc, byte) {
+    crc ^= byte << 8;
+    for(var i = 0; i < 8; i++) {
+        crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc & 0xFFFF;
+}
+
+/**
+ * Build a record
+ * @param  {Number} type   Record type
+ * @param  {Array}  values Values (int16)
+ * @param  {Number} count  Count to put before the values (polygon points,
+ *                         polyline delta bytes)
+ * @return {Buffer}        Record
+ */
+function record(type, values, count) {
+    var head = count == null ? 1 : 2,
+        buf  = Buffer.alloc(head + 2 * values.length);
+
+    buf[0] = type;
+    if(count != null) buf[1] = count;
+
+    values.forEach((v, i) => {
+        if(v < -32768 || v > 32767) throw new RangeError('Value out of range: ' + v);
+        buf.writeInt16LE(v, head + 2 * i);
+    });
+
+    return buf;
+}
+
+/**
+ * Zigzag varint of a value: 0, -1, 1, -2 .. as 0, 1, 2, 3 .., 7 bits a byte
+ * low bits first, the top bit set on every byte but the last
+ * @param  {Number} v Value
+ * @return {Array}    Bytes
+ */
+function varint(v) {
+    var z   = v < 0 ? -2 * v - 1 : 2 * v,
+        out = [];
+
+    while(z >= 0x80) {
+        out.push((z & 0x7F) | 0x80);
+        z = Math.floor(z / 0x80);
+    }
+    out.push(z);
+
+    return out;
+}
+
+/**
+ * Build polyline records for the points of a polygon, as many as it takes
+ * to keep each within a frame. Each starts from the last point of the one
+ * before.
+ * @param  {Array} values x y of each point
+ * @return {Array}        Records (Buffers)
+ */
+function polylines(values) {
+    var out = [];
+
+    for(var i = 0; i < values.length / 2 - 1;) {
+        var deltas = [];
+
+        // Deltas up to the next point that does not fit
+        for(var j = i + 1; j < values.length / 2; j++) {
+            var d = varint(values[2*j] - values[2*j - 2]).concat(varint(values[2*j + 1] - values[2*j - 1]));
+            if(6 + deltas.length + d.length > PAYLOAD) break;
+            deltas = deltas.concat(d);
+        }
+
+        var rec = record(POLYLINE, values.slice(2 * i, 2 * i + 2), deltas.length);
+        out.push(Buffer.concat([rec, Buffer.from(deltas)]));
+        i = j - 1;
+    }
+
+    return out;
+}
+
+/**
+ * Turn a command list into records, one per shape. Polygons longer than a
+ * frame are split into pieces that carry on from the last point of the one
+ * before. Polygons are sent as polylines, unless their points are so far
+ * apart that the deltas take more bytes.
+ * @param  {Array} list Command list from SVG_Parser
+ * @return {Array}      Records (Buffers)
+ */
+function records(list) {
+    var out    = [],
+        type   = null,
+        values = null;
+
+    for(var token of list) {
+
+        // Start of a shape, the type comes next
+        if(token == 'p') {
+            type = '';
+            values = [];
+
+        // Type of the shape
+        } else if(type === '') {
+            type = token;
+
+        // A value
+        } else if(/;$/.test(token)) {
+            values.push(parseInt(token, 10));
+
+        // End of the shape
+        } else if(token == 'q') {
+            if(type == 'P') {
+                var polygon = [], line = polylines(values);
+                for(var i = 0; i < values.length / 2 - 1; i += POINTS - 1) {
+                    var piece = values.slice(2 * i, 2 * (i + POINTS));
+                    polygon.push(record(TYPES.P, piece, piece.length / 2));
+                }
+                var bytes = (recs) => recs.reduce((sum, rec) => sum + rec.length, 0);
+                out = out.concat(bytes(line) <= bytes(polygon) ? line : polygon);
+            } else if(type == 'E' && values.length > 4) {
+                out.push(record(ROTATED, values));
+            } else {
+                out.push(record(TYPES[type], values));
+            }
+            type = null;
+
+        // End of the list
+        } else if(token == 'u') {
+            out.push(Buffer.from([END]));
+        }
+    }
+
+    return out;
+}
+
+/**
+ * Wrap a payload into a frame
+ * @param  {Number} seq     Frame number
+ * @param  {Buffer} payload Payload (1 to 48 bytes)
+ * @return {Buffer}         Frame, escaped as it is sent
+ */
+function frame(seq, payload) {
+    var body = Buffer.concat([Buffer.from([seq & 0xFF, payload.length]), payload, Buffer.alloc(2)]),
+        sum  = 0,
+        out  = [START];
+
+    for(var i = 0; i < body.length - 2; i++) sum = crc(sum, body[i]);
+    body.writeUInt16LE(sum, body.length - 2);
+
+    for(var byte of body) {
+        if(byte == START || byte == ESCAPE) out.push(ESCAPE, byte ^ FLIP);
+        else out.push(byte);
+    }
+
+    return Buffer.from(out);
+}
+
+/**
+ * Encode a command list into frame payloads, packing as many records into
+ * each as fit
+ * @param  {Array} list Command list from SVG_Parser
+ * @return {Array}      Payloads (Buffers), frame() wraps them
+ */
+function encode(list) {
+    var payloads = [],
+        payload  = [],
+        size     = 0;
+
+    for(var rec of records(list)) {
+        if(size + rec.length > PAYLOAD) {
+            payloads.push(Buffer.concat(payload));
+            payload = [];
+            size = 0;
+        }
+        payload.push(rec);
+        size += rec.length;
+    }
+    if(size > 0) payloads.push(Buffer.concat(payload));
+
+    return payloads;
+}
+
+/**
+ * Bytes the records of a payload take in the plotter's shape table: as in
+ * the frame, a polygon or polyline one more (its count is an int there) and
+ * the end none
+ * @param  {Buffer} payload Payload
+ * @return {Number}         Bytes
+ */
+function cost(payload) {
+    var bytes = 0;
+
+    for(var at = 0; at < payload.length;) {
+        var type = payload[at];
+
+        if(type == END) {
+            at++;
+        } else if(type == TYPES.P) {
+            bytes += 3 + 4 * payload[at + 1];
+            at += 2 + 4 * payload[at + 1];
+        } else if(type == POLYLINE) {
+            bytes += 7 + payload[at + 1];
+            at += 6 + payload[at + 1];
+        } else {
+            bytes += SIZES[type];
+            at += SIZES[type];
+        }
+    }
+
+    return bytes;
+}
+
+/**
+ * Sends frames to the plotter, as many in flight as its credit allows
+ * @param {Array}    payloads Frame payloads (from encode()), numbered from 0
+ * @param {Function} write    Writes a frame to the serial port, given the
+ *                            frame and its number
+ */
+function Sender(payloads, write) {
+    this.frames = payloads.map((p, i) => frame(i, p)); // Frames to send
+    this.costs  = payloads.map((p, i) =>               // Room each frame takes, table
+        Math.max(cost(p), this.frames[i].length));     // or wire bytes, the most
+    this.write  = write;  // Writes a frame to the serial port
+    this.base   = 0;      // First frame not acked
+    this.next   = 0;      // Next frame to send
+    this.room   = 0;      // Table bytes free for the frames after base - 1
+    this.acked  = false;  // Had an ack, until then one frame at a time
+    this.back   = -1;     // base when last sent again, once per base
+    this.timer  = null;   // Send again when no ack comes
+}
+
+/**
+ * Send the frames the credit allows
+ */
+Sender.prototype.fill = function() {
+    var bytes = 0;
+
+    for(var i = this.base; i < this.next; i++) bytes += this.costs[i];
+
+    while(this.next < this.frames.length && this.next - this.base < WINDOW) {
+
+        // Out of credit, wait for an ack
+        if(this.acked ? bytes + this.costs[this.next] > this.room : this.next > this.base) break;
+
+        this.write(this.frames[this.next], this.next);
+        bytes += this.costs[this.next];
+        this.next++;
+    }
+
+    clearTimeout(this.timer);
+    if(this.next > this.base) this.timer = setTimeout(() => this.resend(), TIMEOUT);
+};
+
+/**
+ * Go back and send every frame from the first not acked again
+ */
+Sender.prototype.resend = function() {
+    this.back = this.base;
+    this.next = this.base;
+    this.fill();
+};
+
+/**
+ * Frames up to seq are in, with room for more
+ * @param {Number} seq  Last frame taken in
+ * @param {Number} room Table bytes free for the frames after it
+ */
+Sender.prototype.ack = function(seq, room) {
+    var n = (seq - this.base + 1) & 0xFF;
+
+    // From before frames it has had since, or from before the first
+    if(n > this.next - this.base) return;
+
+    this.base += n;
+    this.room = room;
+    this.acked = true;
+    this.fill();
+};
+
+/**
+ * A frame was corrupt or lost, send again from seq (once, for the naks of
+ * the frames in flight after it)
+ * @param {Number} seq Next frame wanted
+ */
+Sender.prototype.nak = function(seq) {
+    if(seq != (this.base & 0xFF) || this.back == this.base) return;
+    this.resend();
+};
+
+/**
+ * The plotter is out of room (over the credit), the ack comes once it has
+ * made some, do not send again until then
+ */
+Sender.prototype.wait = function() {
+    clearTimeout(this.timer);
+};
+
+/**
+ * Every frame is acked
+ * @return {Boolean}
+ */
+Sender.prototype.done = function() {
+    return this.base >= this.frames.length;
+};
+
+module.exports = { encode: encode, frame: frame, records: records, crc: crc, cost: cost, varint: varint, Sender: Sender };
@@ -66,6 +66,18 @@
  *                      Ellipse(100, 100, 50, 10, {100, 100}, 45)
  *                      ['p', 'E', '100;', '100;', '50;', '10;', '100;', '100;', '45;', 'q']
  *
+ *     'F|R'        Speed limits instead of a shape, used for the moves after it
+ *                  ['p', ('F'|'R'), start, speed, accel, 'q']
+ *                  'F'   = Drawing speed (pen down)
+ *                  'R'   = Rapid speed (pen up)
+ *                  start = Speed it can start and stop at (steps/s)
+ *                  speed = Top speed (steps/s)
+ *                  accel = Acceleration (steps/s/s)
+ *
+ *                  eg:
+ *                      Rapid(100, 1000, 2000)
+ *                      ['p', 'R', '100;', '1000;', '2000;', 'q']
+ *
  *     '...;'       The integer values for the shape data, 0-99999; the ';' is
  *                  to inform the Plotter the number is done and to go to next
  *                  number
@@ -233,12 +245,26 @@ Rect = (obj) => {
     return Polygon(points);
 }
 
+/**
+ * Convert speed limits into a Feed or Rapid command array
+ * @param  {String} type 'F' (drawing) or 'R' (pen up)
+ * @param  {Object} obj  Speed limits { start, speed, accel } (steps/s)
+ * @return {Array}       Command list ['p', ('F'|'R'), ..., 'q']
+ */
+Speed = (type, obj) => {
+    return ['p', type,
+        Math.round(obj.start)+comma,
+        Math.round(obj.speed)+comma,
+        Math.round(obj.accel)+comma, 'q'];
+}
+
 /**
  * Exports parser for parsing a SVG file into a command list
- * @param  {string} file Path of the file to read
- * @return {Array}      Command list ['n', 'p', ..., 'q', 'u']
+ * @param  {string} file   Path of the file to read
+ * @param  {Object} speeds Optional speed limits { feed, rapid } to send first
+ * @return {Array}         Command list ['n', 'p', ..., 'q', 'u']
  */
-module.exports = function(file){
+module.exports = function(file, speeds){
     // Command list to build on
     var list     = ['n'], // Start drawing data command
 
@@ -246,6 +272,10 @@ module.exports = function(file){
         SVG      = parse(fs.readFileSync(file, 'utf8')).root,
         shapes;
 
+    // Speed limits go first so they apply to every shape
+    if(speeds && speeds.feed) list = list.concat(Speed('F', speeds.feed));
+    if(speeds && speeds.rapid) list = list.concat(Speed('R', speeds.rapid));
+
     // Loop through all of the children of SVG and find 'g' (where the shapes
     // are held)
     for(var i of SVG.children){
@@ -0,0 +1,91 @@
+/**
+ *  Telemetry.js
+ *
+ *  Decodes the binary telemetry frames the XY-Plotter mixes into its Serial
+ *  output (see src/Project/Telemetry.h). Frames are taken out of the data and
+ *  passed to a callback, the rest is returned as text.
+ *
+ *  Frame (10 bytes, little endian):
+ *
+ *      0xA5 seq x(int16) y(int16) segment(uint16) depth(uint8) sum
+ *
+ *      seq      Frame number, gaps are frames the plotter dropped
+ *      x, y     Position of the steppers
+ *      segment  Segment being drawn (or the last one drawn)
+ *      depth    Segments queued on the plotter
+ *      sum      8 bit sum of seq through depth
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+const START = 0xA5, // First byte of a frame (never sent in text)
+      FRAME = 10;   // Bytes in a frame
+
+/**
+ * Telemetry decoder
+ * @param {Function} onFrame Called with each frame
+ *                           { seq, x, y, segment, depth, dropped }
+ */
+function Telemetry(onFrame) {
+    this.onFrame = onFrame;
+    this.pending = Buffer.alloc(0); // Start of a frame waiting for the rest
+    this.seq = null;                // Number of the last frame
+    this.dropped = 0;               // Frames dropped by the plotter so far
+    this.bad = 0;                   // Frames with a bad sum
+}
+
+/**
+ * Decode a chunk of data from the serial port
+ * @param  {Buffer} data Data from the plotter
+ * @return {String}      Text that was not part of a frame
+ */
+Telemetry.prototype.push = function(data) {
+    var buf  = Buffer.concat([this.pending, data]),
+        text = '',
+        i    = 0;
+
+    while(i < buf.length) {
+
+        // Plain text
+        if(buf[i] != START) {
+            text += String.fromCharCode(buf[i]);
+            i++;
+            continue;
+        }
+
+        // Wait for the rest of the frame
+        if(buf.length - i < FRAME) break;
+
+        var sum = 0;
+        for(var k = 1; k < FRAME - 1; k++) sum = (sum + buf[i+k]) & 0xFF;
+
+        // Not a frame (corrupted), skip the start byte and resync
+        if(sum != buf[i+FRAME-1]) {
+            this.bad++;
+            i++;
+            continue;
+        }
+
+        var frame = {
+            seq:     buf[i+1],
+            x:       buf.readInt16LE(i+2),
+            y:       buf.readInt16LE(i+4),
+            segment: buf.readUInt16LE(i+6),
+            depth:   buf[i+8]
+        };
+
+        // Count the frames the plotter dropped since the last one
+        if(this.seq != null) this.dropped += (frame.seq - this.seq - 1) & 0xFF;
+        this.seq = frame.seq;
+        frame.dropped = this.dropped;
+
+        this.onFrame(frame);
+        i += FRAME;
+    }
+
+    this.pending = buf.slice(i);
+    return text;
+};
+
+module.exports = Telemetry;
@@ -4,19 +4,37 @@
  *  Controller for connecting and command XY-Plotter
  *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.3.0
  *  @license MIT (https://mit-license.org)
  */
 const SerialPort = require('serialport'),
       os         = require('os'),
       fs         = require('fs'),
       https      = require('https'),
-      SVG_parser = require('./SVG_Parser');
+      SVG_parser = require('./SVG_Parser'),
+      Telemetry  = require('./Telemetry'),
+      Link       = require('./Link');
+
+// Speed limits (steps/s, steps/s/s), feed while drawing, rapid with the pen up
+var speeds = {
+    feed:  { start: 100, speed: 600,  accel: 1000 },
+    rapid: { start: 100, speed: 1000, accel: 2000 }
+};
 
 // Get command array
-var list = SVG_parser('../TEST.svg'),
+var list = SVG_parser('../TEST.svg', speeds),
     ind  = 0;
 
+// Send the shapes as binary frames (see Link.js), false for the text protocol
+// (a ;next; round trip per chunk)
+var binary = true,
+    sender = null;
+
+// Baud to ask the plotter for in the handshake (it starts at 9600), null to
+// stay at 9600. 115200 up to 1000000, not 230400 (see src/Project/lib/Uart.h)
+var baud   = 115200,
+    asked  = false;
+
 // console.log(list);
 
 // Portname for arduino
@@ -51,39 +69,76 @@ if(portname != null) {
     // Data from arduino
     var dataString = '';
 
+    // Position frames from arduino (printed data)
+    var telemetry = new Telemetry((frame) => {
+        console.log('(' + frame.x + ',' + frame.y + ') segment: ' + frame.segment +
+                    ' queued: ' + frame.depth + ' dropped: ' + frame.dropped);
+    });
+
     // When serial port opens
     serialPort.on('open', () => {
 
         // On getting data (Serial.print(ln));
         serialPort.on('data', (data) => {
-            dataString+=data; // Add data chunk to string
+            dataString+=telemetry.push(data); // Add text of the data chunk to string
 
-            if(/\r|\n/.test(dataString)){ // When we get a newline (Serial.println)
+            // Each whole line (Serial.println), a chunk can hold more than
+            // one, the rest of a line still coming in is kept
+            var lines = dataString.split(/\r\n|\r|\n/);
+            dataString = lines.pop();
 
-                // Remove newline/carriage return from string
-                dataString = dataString.replace(/\r|\n/g, '');
+            for(var line of lines){
 
                 // The arduino is trying to establish a connection
-                if(dataString == ';Ready;'){
+                if(line == ';Ready;' && baud && !asked){
+                    console.log('Send: b' + baud + ';');
+                    serialPort.write('b' + baud + ';'); // Ask for a faster baud
+                    asked = true;
+                } else if(line == ';Ready;'){
                     console.log('Send: n');
-                    if(ind != 0){
+                    if(binary ? sender && sender.done() : ind != 0){
                         console.log('done!');
                     }
                     serialPort.write('n'); // Send 'n', informing we have a
                                            // and we are ready to send data
                 }
 
+                // The plotter changes to this baud, ;Ready; comes again at it
+                var reply = /^;baud (\d+);$/.exec(line);
+                if(reply) serialPort.update({ baudRate: +reply[1] });
+
+                // Frames are in, send as many more as there is room for
+                reply = /^;ack (\d+) (\d+);$/.exec(line);
+                if(binary && reply) sender.ack(+reply[1], +reply[2]);
+
+                // A frame was corrupt, send again from the one it wants
+                reply = /^;nak (\d+);$/.exec(line);
+                if(binary && reply) sender.nak(+reply[1]);
+
+                // The plotter is out of room, the ack comes once it has made
+                // some, do not send again until then
+                if(binary && line == ';wait;') sender.wait();
+
+                // Connected, start sending frames. After this the plotter
+                // asks with acks, not ;next;
+                if(binary && line == ';next;' && !sender){
+                    sender = new Link.Sender(Link.encode(list), (frame, n) => {
+                        console.log('Send: frame ' + n);
+                        serialPort.write(frame);
+                    });
+                    sender.fill();
+                }
+
                 // The arduino wants the next chunk of data
-                if(dataString == ';next;'){
+                if(!binary && line == ';next;'){
                     console.log('Send: '+list[ind]);
                     serialPort.write(list[ind]); // Send the next chunk of data
                     ind++;
                 }
 
                 // If the string is not ';Ready;' or ';next;' print data
-                // if(!/;next;|;Ready;/g.test(dataString)) console.log(dataString);
-                console.log(dataString);
-                dataString = ''; // Reset data string
+                // if(!/;next;|;Ready;/g.test(line)) console.log(line);
+                console.log(line);
 
             }
         });
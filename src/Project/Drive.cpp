@@ -5,8 +5,14 @@
  *  Maintains control over X and Y positions, movement along the x and y-axis.
  *  Maintains control over the pens up and down position
  *
+ *  lineTo(), arcTo() and moveTo() only queue the move and return. The
+ *  steppers are stepped out from the Timer2 compare interrupt (Timer1 belongs
+ *  to Servo), so the main loop is free to read Serial and plan shapes while
+ *  drawing. While a long shape waits on room in the queue the wait hook
+ *  (setWait) is run instead, to keep reading.
+ *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.0.5
  *  @license MIT (https://mit-license.org)
  */
 #include <Arduino.h>
@@ -30,13 +36,16 @@ Drive::Drive(
     int up,
     int down,
     LiquidCrystal *lcd
-):    _x(x, del),
+):    _del(del),
+      _x(x, del),
       _y(y, del),
+      _rapidX(_x.getProfile()),
+      _rapidY(_y.getProfile()),
       _abx(x.btnPin, x.btn1, x.btn2, x.buff),
       _aby(y.btnPin, y.btn1, y.btn2, y.buff),
-      _del(del),
       _pen(servo, up, down, del),
-      _lcd(lcd){};
+      _status(lcd),
+      _telemetry(false){};
 
 /**
  * Driver constructor (singleton)
@@ -58,26 +67,66 @@ Drive::Drive(
     int down,
     LiquidCrystal *lcd,
     bool p
-):    _x(x, del),
+):    _del(del),
+      _x(x, del),
       _y(y, del),
+      _rapidX(_x.getProfile()),
+      _rapidY(_y.getProfile()),
       _abx(x.btnPin, x.btn1, x.btn2, x.buff),
       _aby(y.btnPin, y.btn1, y.btn2, y.buff),
-      _del(del),
       _pen(servo, up, down, del),
-      _lcd(lcd),
-      _p(p) {};
+      _status(lcd),
+      _telemetry(p) {};
+
+// Timer2 ticks are 2us (16MHz / 32)
+#define TICK_US 2
+
+// Ticks between checks of the queue while idle (timer max)
+#define IDLE_TICKS 256
+
+// Steps in each queued piece of an arc, each piece has its own speed limit
+#define ARC_PIECE 32
+
+// Drive stepped by the timer interrupt
+Drive *Drive::_active = NULL;
 
 /**
-* Used to setup Drive (call within setup())
+ * Step timer, Timer2 compare match A
+ */
+ISR(TIMER2_COMPA_vect) {
+    Drive::isr();
+}
+
+/**
+* Used to setup Drive (call within setup()), starts the step timer
 */
 void Drive::attach() {
     _pen.attach();
     _x.attach();
     _y.attach();
+    _abx.attach();
+    _aby.attach();
+
+    // Timer2 in CTC mode, /32 prescaler (2us ticks), interrupt on compare A
+    noInterrupts();
+    _active = this;
+    TCCR2A = _BV(WGM21);
+    TCCR2B = _BV(CS21) | _BV(CS20);
+    TCNT2 = 0;
+    OCR2A = IDLE_TICKS - 1;
+    TIMSK2 = _BV(OCIE2A);
+    interrupts();
+};
+
+/**
+ * Step timer interrupt handler, do not call
+ */
+void Drive::isr() {
+    if(_active != NULL) _active->tick();
 };
 
 /**
- * Draw a line from current POS to new POS
+ * Queue a line from current POS to new POS
  * @param  x New X position
  * @param  y New Y position
  * @return   Updated POS
@@ -87,7 +136,7 @@ POS Drive::lineTo(int x, int y) {
 };
 
 /**
- * Move the pen from current POS to new POS
+ * Queue a move of the pen from current POS to new POS
  * @param  x New X position
  * @param  y New Y position
  * @return   Updated POS
@@ -103,37 +152,113 @@ POS Drive::moveTo(int x, int y) {
 };
 
 /**
- * Return the pen to origin point (0,0)
+ * Queue a quarter ellipse from current POS to new POS, drawn step by step
+ * from the step interrupt. The ellipse is axis-aligned, centred on the corner
+ * of the box between the two points that the arc bends around.
+ * @param  x      New X position
+ * @param  y      New Y position
+ * @param  alongX Leave along x and arrive along y (true), or leave along y
+ *                and arrive along x (false)
+ * @return        Updated POS
+ */
+POS Drive::arcTo(int x, int y, bool alongX) {
+    POS from = _xy;
+    int dx = x - from.x;
+    int dy = y - from.y;
+
+    // An arc that only moves along one axis is flat, a line
+    if(dx == 0 || dy == 0) return lineTo(x, y);
+
+    int sx = dx > 0 ? 1 : -1;
+    int sy = dy > 0 ? 1 : -1;
+    unsigned int ax = dx * sx;
+    unsigned int ay = dy * sy;
+
+    // Semi-axes, a along u (the axis it leaves from the tip of) and b along v
+    unsigned int a = alongX ? ay : ax;
+    unsigned int b = alongX ? ax : ay;
+    uint8_t kind = alongX ? SEGMENT_ARC_X : SEGMENT_ARC_Y;
+
+    Arc arc;
+    arc.begin(a, b);
+    unsigned int u = 0; // Steps taken along u
+    unsigned int v = 0; // Steps taken along v
+
+    // Trace the steps the interrupt will take and queue them in pieces, so
+    // each piece is only slowed for its own bend. A piece ends after
+    // ARC_PIECE steps, or sooner where the bend doubles or halves.
+    for(;;) {
+        unsigned int ticks = 0;
+        unsigned int r0 = Arc::radius(a, b, a - u, v);
+        unsigned int r = r0;
+        uint8_t step;
+
+        while(ticks < ARC_PIECE && (step = arc.next()) != 0) {
+            if(step & ARC_U) u++;
+            if(step & ARC_V) v++;
+            ticks++;
+
+            r = Arc::radius(a, b, a - u, v);
+            if(r / 2 >= r0 || r0 / 2 >= r) break;
+        }
+        if(ticks == 0) break;
+        r = min(r, r0);
+
+        // Hitting an extreme while waiting for room sends us home, drop the
+        // rest of the arc
+        room();
+        if(_xy.x != from.x || _xy.y != from.y) break;
+
+        from.x = x - (int)(alongX ? b - v : a - u) * sx;
+        from.y = y - (int)(alongX ? a - u : b - v) * sy;
+
+        Segment *seg = fill(from.x, from.y, false);
+        seg->kind = kind;
+        seg->dx = ax;
+        seg->dy = ay;
+        seg->ticks = ticks;
+
+        // Keep the pull around the bend in the acceleration limit,
+        //   v^2 / r <= accel
+        unsigned int limit = Fixed::isqrt((unsigned long)r * seg->profile.accel);
+        if(limit < seg->profile.start) limit = seg->profile.start;
+        if(limit < seg->profile.speed) seg->profile.speed = limit;
+
+        push(from.x, from.y);
+        kind |= SEGMENT_MORE;
+    }
+
+    return get();
+};
+
+/**
+ * Return the pen to origin point (0,0), waits for queued moves first and for
+ * the pen to lift
  * @return Updated POS (0,0)
  */
 POS Drive::origin() {
 
+    // Finish what is queued, the steppers are driven directly from here
+    sync();
+
+    noInterrupts();
+    _xy = _pos;
+    interrupts();
+
     // Check if collided with extreme
     int x = _abx.check();
     int y = _aby.check();
 
-    // Raise pen, stop drawing
+    // Raise pen, stop drawing, and give it time to get up before dragging
+    // it home
     _pen.up();
+    while(!_pen.ready());
 
     // Get to (0,0)
     while(x != 1 || y != 1) {
 
-        // Print current position to LCD
-        _lcd->setCursor(0,0);
-        _lcd->print("(");
-        _lcd->print(_xy.x);
-        _lcd->print(",");
-        _lcd->print(_xy.y);
-        _lcd->print(")       ");
-
-        if(_p) {
-            // Print current position to Serial
-            Serial.print("(");
-            Serial.print(_xy.x);
-            Serial.print(",");
-            Serial.print(_xy.y);
-            Serial.println(")");
-        }
+        // Shown once we are back in the main loop
+        _status.setPOS(_xy);
 
         // Step once to the left (x-)
         // if not already at x=0
@@ -157,11 +282,16 @@ POS Drive::origin() {
         delay(_del);
     }
     // Serial.println('origin done');
+
+    _xy = { 0, 0 };
+    noInterrupts();
+    _pos = { 0, 0 };
+    interrupts();
     return { 0, 0 };
 };
 
 /**
- * Get the current POS
+ * Get the current POS, the end of the queued moves
  * @return POS, current position
  */
 POS Drive::get() {
@@ -169,7 +299,7 @@ POS Drive::get() {
 };
 
 /**
- * Private controller that does the actual moving
+ * Private controller that queues the move
  * @param  x  New X position
  * @param  y  New Y position
  * @param  up Move pen up (true, dont draw) or down (false, draw)
@@ -177,27 +307,51 @@ POS Drive::get() {
  */
 POS Drive::move(int x, int y, bool up){
 
-    // Get the number of steps needed in x and y.
+    // If no movement to be had, skip unnecessary work.
+    if(_xy.x == x && _xy.y == y) return get();
+
+    // Wait for room in the queue
+    room();
+
+    // Hitting an extreme while waiting resets our position
+    if(fill(x, y, up) == NULL) return get();
+
+    return push(x, y);
+};
+
+/**
+ * Wait for room in the queue, servicing the Drive and running the wait hook
+ * (not from within it)
+ */
+void Drive::room() {
+    while(_queue.full()) {
+        run();
+
+        if(_onWait != NULL && !_inWait) {
+            _inWait = true;
+            _onWait();
+            _inWait = false;
+        }
+    }
+};
+
+/**
+ * Fill the next free slot of the queue with a line from the end of the
+ * queued moves (check there is room first). Queue it with push().
+ * @param  x  New X position
+ * @param  y  New Y position
+ * @param  up Move pen up (true, dont draw) or down (false, draw)
+ * @return    Segment, NULL if there is no movement
+ */
+Segment *Drive::fill(int x, int y, bool up){
+
+    // Get the number of steps needed in x and y
     int diff_x = _xy.x - x;
     int diff_y = _xy.y - y;
-
-    // If no movement to be had, skip unnecessary work.
-    if(diff_x == 0 && diff_y == 0) return get();
+    if(diff_x == 0 && diff_y == 0) return NULL;
 
     int x_dir; // 1=forward, -1=backward
     int y_dir; // 1=forward, -1=backward
-    bool trip = false; // We hit an extreme
-
-    // This helps to ensure that we move at proper angles. If our ratio is 2
-    // (y=2x) we want to step x twice and y once. Increment ratio_cur++ till
-    // ratio_cur=ratio, each of these steps we increase our x. once ratio_cur
-    // matches ratio we increment y and set ratio_cur to 0.
-    int ratio_cur = 0;
-    int ratio = 0;
-
-    // Tells us if we need to step more in the x direction or y. y = 1/2x we
-    // want to step y twice and x once. So xFirst is false. IE. y first
-    bool xFirst = true;
 
     // Get our direction for the x-axis and absolute our difference
     if(diff_x < 0) {
@@ -217,137 +371,410 @@ POS Drive::move(int x, int y, bool up){
     } else if(diff_y > 0) y_dir = 1; // move in y+
     else y_dir = 0; // No y movement
 
-    // We want more y steps than x
-    if(diff_y > diff_x) {
-        // Get our y steps to x steps
-        ratio = (int)round(diff_y/diff_x);
-        xFirst = false; // set to do our steps for y first
-
-    // Get our x steps to y steps
-    } else ratio = (int)round(diff_x/diff_y);
-
-    // Raise or lower our pen
-    if(up) _pen.up(); // moveTo()
-    else _pen.down(); // lineTo()
-
-    // Move to our desired point
-    while((diff_x > 0 || diff_y > 0) && !trip){
-
-        // Print current position to LCD
-        _lcd->setCursor(0,0);
-        _lcd->print("(");
-        _lcd->print(_xy.x);
-        _lcd->print(",");
-        _lcd->print(_xy.y);
-        _lcd->print(")       ");
-
-        if(_p){
-            // Print current position to Serial
-            Serial.print("(");
-            Serial.print(_xy.x);
-            Serial.print(",");
-            Serial.print(_xy.y);
-            Serial.println(")");
+    Segment *seg = _queue.head();
+    seg->id = _count++;
+    seg->kind = SEGMENT_LINE;
+    seg->dx = diff_x;
+    seg->dy = diff_y;
+    seg->xDir = x_dir;
+    seg->yDir = y_dir;
+    seg->up = up;
+    seg->profile = profile(x_dir != 0, y_dir != 0, up);
+    seg->length = length(diff_x, diff_y);
+    seg->ticks = max(diff_x, diff_y);
+    seg->entry = seg->profile.start;
+    seg->busy = false;
+
+    return seg;
+};
 
-        }
+/**
+ * Queue the filled segment, the interrupt picks it up from here
+ * @param  x New X position (the end of the segment)
+ * @param  y New Y position (the end of the segment)
+ * @return   The updated POS
+ */
+POS Drive::push(int x, int y){
+    Segment *seg = _queue.head();
 
-        // Move more in the x direction first (ratio count)
-        if(xFirst) {
-
-            // If we still have steps to take in x and the ratio shows we still
-            // have x steps to take before y. Or our y is already finished, move
-            // in the x direction.
-            if((diff_x > 0 && ratio_cur < ratio) || diff_y <= 0) {
-                if(x_dir > 0) { // Move forward
-                    _x.forward();
-                    _xy.x--; // Decrement x position
-                             // Steppers are flipped (see main.cpp PinMap's)
-
-                } else if(x_dir < 0) { // Move backward
-                    _x.backward();
-                    _xy.x++; // Increment x position
-
-                }
-                diff_x--; // Remove a step needed
-                ratio_cur++; // Increase the ratio count
-            }
-
-            // If we still have steps to take in y and the ratio shows we have
-            // finished the x steps. Or our x is already finished, move
-            // in the y direction.
-            if((diff_y > 0 && ratio_cur >= ratio) || diff_x <= 0) {
-                if(y_dir > 0) { // Move forward
-                    _y.forward();
-                    _xy.y--; // Decrement y position
-
-                } else if(y_dir < 0) { // Move backward
-                    _y.backward();
-                    _xy.y++; // Increment y position
-
-                }
-                diff_y--; // Remove a step needed
-                ratio_cur = 0; // Reset our ratio count
-            }
-
-        // Move in the y direction first (ratio count)
-        } else {
+    // How fast we can take the corner from the last queued segment. With
+    // nothing queued we start from rest.
+    if(_queue.empty()) seg->maxEntry = seg->profile.start;
+    else seg->maxEntry = _planner.junction(_queue.last(), seg);
 
-            // If we still have steps to take in y and the ratio shows we still
-            // have y steps to take before x. Or our x is already finished, move
-            // in the y direction.
-            if((diff_y > 0 && ratio_cur < ratio) || diff_x <= 0) {
-                if(y_dir > 0) { // Move forward
-                    _y.forward();
-                    _xy.y--; // Decrement y position
-
-                } else if(y_dir < 0) { // Move backward
-                    _y.backward();
-                    _xy.y++; // Increment y position
-                }
-                diff_y--; // Remove a step needed
-                ratio_cur++; // Increment the ratio count
-            }
-
-            // If we still have steps to take in x and the ratio shows we have
-            // finished the y steps. Or our y is already finished, move
-            // in the x direction.
-            if((diff_x > 0 && ratio_cur >= ratio) || diff_y <= 0) {
-                if(x_dir > 0) { // Move forward
-                    _x.forward();
-                    _xy.x--; // Decrement x position
-
-                } else if(x_dir < 0) { // Move backward
-                    _x.backward();
-                    _xy.x++; // Increment x position
-                }
-                diff_x--; // Remove a step needed
-                ratio_cur = 0; // Reset the ratio count
-            }
+    _queue.push();
 
-        }
+    // Re-plan the speeds through the queue with the new segment on the end
+    _planner.plan(&_queue);
 
-        // Check if we collided with an extreme
-        if(_abx.check() != 0 || _aby.check() != 0) {
-            trip = true;
-        }
-    }
+    _xy = { x, y };
+
+    run();
 
-    // If we hit an extreme reset the XY-Plotter, inform user
-    if(trip) {
+    // Return updated position
+    return get();
+};
+
+/**
+ * Service the Drive from the main loop: print the position, check the
+ * extremes and power down idle steppers. Call often.
+ * @return true while there are moves left to step out
+ */
+bool Drive::run() {
+
+    noInterrupts();
+    POS pos = _pos;
+    uint8_t depth = _queue.size();
+    unsigned int id = depth > 0 ? _queue.tail()->id : _count - 1;
+    interrupts();
+
+    // Show the current position, redrawn at most every STATUS_INTERVAL
+    _status.setPOS(pos);
+    _status.update();
+
+    // Send what the UART has room for, drop the oldest frames if it lags
+    _telemetry.record(pos, id, depth);
+    _telemetry.drain();
+
+    // If we hit an extreme reset the XY-Plotter (the interrupt has already
+    // stopped stepping)
+    if(_trip) {
         // Serial.println("origin");
+        stop();
         _xy = origin();
         _x.setPOS(0);
         _y.setPOS(0);
     }
 
-    // Return updated position
-    return get();
+    // The steppers stay powered while there is work (the step interrupt
+    // powers them up), power them down once they have been idle for a while
+    if(busy()) {
+        _moved = millis();
+
+    } else if(DRIVE_IDLE > 0 && millis() - _moved >= DRIVE_IDLE) {
+        noInterrupts();
+        if(!busy()) {
+            _x.disable();
+            _y.disable();
+        }
+        interrupts();
+    }
+
+    return busy();
+};
+
+/**
+ * Wait until every queued move has been stepped out
+ */
+void Drive::sync() {
+    while(run());
+};
+
+/**
+ * Moves left to step out (the segment being stepped stays queued till done),
+ * or a tripped limit that run() has not homed from yet
+ * @return true/false
+ */
+bool Drive::busy() {
+    return !_queue.empty() || _trip;
+};
+
+/**
+ * Stop stepping and drop all queued moves
+ */
+void Drive::stop() {
+    noInterrupts();
+    _queue.clear();
+    _seg = NULL;
+    _sx = 0;
+    _sy = 0;
+    _wait = 0;
+    _trip = false;
+    interrupts();
+};
+
+/**
+ * Run a single timer tick (interrupt)
+ */
+void Drive::tick() {
+
+    // Still waiting out the delay before the next step
+    if(_wait > 0) {
+        arm();
+        return;
+    }
+
+    // Delay is up, step and work out the next step
+    pulse();
+
+    // Check if we collided with an extreme, stop till run() sends us home.
+    // Only a switch that has just closed is a hit, one already closed is one
+    // we are moving off (both are closed after origin(), and the cached
+    // state lags the steps).
+    int8_t x = _abx.check();
+    int8_t y = _aby.check();
+    if(_seg != NULL && ((x != 0 && x != _limitX) || (y != 0 && y != _limitY))) {
+        _trip = true;
+        _seg = NULL;
+        _queue.clear();
+    }
+    _limitX = x;
+    _limitY = y;
+
+    plan();
+    arm();
+};
+
+/**
+ * Start stepping out a segment (interrupt)
+ * @param seg Segment from the queue
+ */
+void Drive::begin(Segment *seg) {
+    _seg = seg;
+    seg->busy = true;
+    _left = seg->ticks;
+
+    // A new arc starts from its tip, later pieces carry on where it got to
+    if(!(seg->kind & SEGMENT_MORE)) {
+        if(seg->kind & SEGMENT_ARC_Y) _arc.begin(seg->dx, seg->dy);
+        else if(seg->kind & SEGMENT_ARC_X) _arc.begin(seg->dy, seg->dx);
+    }
+
+    _xMajor = seg->dx >= seg->dy;
+
+    if(_xMajor) {
+        _major = seg->dx;
+        _minor = seg->dy;
+    } else {
+        _major = seg->dy;
+        _minor = seg->dx;
+    }
+
+    // One tick per major axis step. Starting the accumulator half way rounds
+    // the minor axis to the nearest step of the ideal line.
+    _acc = _major / 2;
+
+    // Planned speeds are along the move, the ramp runs on the ticks
+    //   tick speed = speed * ticks / length
+    unsigned long entry = (unsigned long)seg->entry * _left / seg->length;
+    unsigned long exit = seg->profile.start;
+
+    // Leave at the speed the next segment was planned to enter at
+    if(_queue.size() > 1) {
+        exit = (unsigned long)_queue.get(1)->entry * _left / seg->length;
+    }
+
+    // Ramp up and down over the ticks of the segment
+    _ramp.begin(_left, seg->profile, entry, exit);
+};
+
+/**
+ * Work out the steps for the next tick and how long to wait (interrupt).
+ * Steps the major axis every tick and the minor axis whenever its error
+ * accumulator rolls over (Bresenham), so both can step in the same tick.
+ */
+void Drive::plan() {
+
+    // Segment is done, take it off the queue
+    if(_seg != NULL && _left == 0) {
+        _seg = NULL;
+        _queue.pop();
+    }
+
+    // Start on the next segment, or idle till there is one
+    if(_seg == NULL) {
+        if(_queue.empty() || _trip) {
+            _wait = IDLE_TICKS;
+            return;
+        }
+
+        // Raise or lower our pen. Lifting overlaps the start of the move, a
+        // line waits till the pen has had time to get down and settle.
+        Segment *seg = _queue.tail();
+        if(seg->up) _pen.up(); // moveTo()
+        else if(!_pen.down()) { // lineTo()
+            _wait = IDLE_TICKS;
+            return;
+        }
+        begin(seg);
+    }
+
+    // Arc, u is the axis it leaves from the tip of
+    if(_seg->kind != SEGMENT_LINE) {
+        uint8_t step = _arc.next();
+        bool u = step & ARC_U;
+        bool v = step & ARC_V;
+
+        if(_seg->kind & SEGMENT_ARC_Y) {
+            _sx = u ? _seg->xDir : 0;
+            _sy = v ? _seg->yDir : 0;
+        } else {
+            _sy = u ? _seg->yDir : 0;
+            _sx = v ? _seg->xDir : 0;
+        }
+        _left--;
+
+        _wait = _ramp.next() / TICK_US;
+        return;
+    }
+
+    // Minor axis is due a step once it has built up a full major step
+    bool minor = false;
+    _acc += _minor;
+    if(_acc >= _major) {
+        _acc -= _major;
+        minor = true;
+    }
+
+    if(_xMajor) {
+        _sx = _seg->xDir;
+        _sy = minor ? _seg->yDir : 0;
+    } else {
+        _sy = _seg->yDir;
+        _sx = minor ? _seg->xDir : 0;
+    }
+    _left--;
+
+    _wait = _ramp.next() / TICK_US;
+};
+
+/**
+ * Step the axes planned for this tick (interrupt)
+ */
+void Drive::pulse() {
+
+    if(_sx > 0) { // Move forward
+        _x.forward();
+        _pos.x--; // Decrement x position
+                  // Steppers are flipped (see main.cpp PinMap's)
+
+    } else if(_sx < 0) { // Move backward
+        _x.backward();
+        _pos.x++; // Increment x position
+    }
+
+    if(_sy > 0) { // Move forward
+        _y.forward();
+        _pos.y--; // Decrement y position
+
+    } else if(_sy < 0) { // Move backward
+        _y.backward();
+        _pos.y++; // Increment y position
+    }
+
+    _sx = 0;
+    _sy = 0;
+};
+
+/**
+ * Load the timer with the next part of the wait (interrupt)
+ */
+void Drive::arm() {
+    unsigned long t = _wait;
+
+    // The timer only counts to 256 ticks, wait out longer delays in parts.
+    // Parts are kept at half the timer or more so there is time to run them.
+    if(t > IDLE_TICKS + IDLE_TICKS / 2) t = IDLE_TICKS;
+    else if(t > IDLE_TICKS) t = t / 2;
+    _wait -= t;
+
+    // Already counted past it while running this tick, fire right away
+    unsigned int now = TCNT2;
+    if(t < now + 2) t = now + 2;
+    if(t > IDLE_TICKS) t = IDLE_TICKS;
+
+    OCR2A = t - 1;
+};
+
+/**
+ * Length of a move, rounded to the nearest step
+ * @param  dx Steps along x
+ * @param  dy Steps along y
+ * @return    Length (steps)
+ */
+unsigned int Drive::length(unsigned int dx, unsigned int dy) {
+    unsigned long n = (unsigned long)dx * dx + (unsigned long)dy * dy;
+    unsigned long len = Fixed::isqrt(n);
+
+    // sqrt(n) >= len + 0.5 when n > len^2 + len
+    if(n - len * len > len) len++;
+
+    return len;
+};
+
+/**
+ * Get the profile for a move, limited by the axes that move
+ * @param  x  Moving along x
+ * @param  y  Moving along y
+ * @param  up Pen up, use the rapid profiles
+ * @return    Profile
+ */
+Profile Drive::profile(bool x, bool y, bool up) {
+    Profile px = up ? _rapidX : _x.getProfile();
+    Profile py = up ? _rapidY : _y.getProfile();
+
+    if(!x) return py;
+    if(!y) return px;
+
+    return {
+        min(px.start, py.start),
+        min(px.speed, py.speed),
+        min(px.accel, py.accel)
+    };
+};
+
+/**
+ * Set the speed limits of each axis while drawing (lineTo)
+ * @param x Profile for the X stepper
+ * @param y Profile for the Y stepper
+ */
+void Drive::setProfile(Profile x, Profile y) {
+    _x.setProfile(x);
+    _y.setProfile(y);
+};
+
+/**
+ * Set the speed limits of each axis with the pen up (moveTo). Until set
+ * these are the steppers' defaults.
+ * @param x Profile for the X stepper
+ * @param y Profile for the Y stepper
+ */
+void Drive::setRapid(Profile x, Profile y) {
+    _rapidX = x;
+    _rapidY = y;
+};
+
+/**
+ * Set a function run while a move waits on room in the queue, so the main
+ * loop's work (reading the client) goes on while a long shape is queued. It
+ * must not queue moves.
+ * @param wait Function, NULL for none
+ */
+void Drive::setWait(void (*wait)()) {
+    _onWait = wait;
+};
+
+/**
+ * Get the status display
+ * @return Status
+ */
+Status *Drive::status() {
+    return &_status;
+};
+
+/**
+ * Get the telemetry channel
+ * @return Telemetry
+ */
+Telemetry *Drive::telemetry() {
+    return &_telemetry;
 };
 
 /**
- * Set the pen low point
+ * Set the pen low point, waits for queued moves first
  * @param ro read-out
  */
 int Drive::setPen(int ro) {
+    sync();
     return _pen.setDown(ro);
 };
@@ -5,37 +5,94 @@
  *  Maintains control over X and Y positions, movement along the x and y-axis.
  *  Maintains control over the pens up and down position
  *
+ *  lineTo(), arcTo() and moveTo() only queue the move and return. The
+ *  steppers are stepped out from the Timer2 compare interrupt (Timer1 belongs
+ *  to Servo), so the main loop is free to read Serial and plan shapes while
+ *  drawing. While a long shape waits on room in the queue the wait hook
+ *  (setWait) is run instead, to keep reading.
+ *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.0.5
  *  @license MIT (https://mit-license.org)
  */
 #ifndef DRIVE_H
 #define DRIVE_H
 #include "stepper/POS.h"
 #include "stepper/Stepper.h"
+#include "stepper/FastStepper.h"
+#include "stepper/Ramp.h"
+#include "stepper/Arc.h"
+#include "stepper/SegmentQueue.h"
+#include "stepper/Planner.h"
 #include "stepper/Pen.h"
 #include "stepper/AnalogButtons.h"
+#include "lib/Fixed.h"
 #include "lib/ShiftedLCD.h"
+#include "Status.h"
+#include "Telemetry.h"
+#include "Pins.h"
 #include <Arduino.h>
 
+// Power down the steppers after this long idle (ms), 0 keeps them powered.
+// They power back up on the next step.
+#define DRIVE_IDLE 10000
+
+// Steppers with their pins fixed at compile time (direct port writes). Build
+// with -D PINMAP_STEPPERS to drive the PinMap pins with digitalWrite instead.
+#ifdef PINMAP_STEPPERS
+typedef Stepper XStepper;
+typedef Stepper YStepper;
+#else
+typedef FastStepper<X_STEP_PIN, X_DIR_PIN, X_ENABLE_PIN> XStepper;
+typedef FastStepper<Y_STEP_PIN, Y_DIR_PIN, Y_ENABLE_PIN> YStepper;
+#endif
+
 /**
  * Drive controller, used to control both steppers and servo, and reads
  *   interupts from the AnalogButtons
  */
 class Drive {
 private:
-    int _del;            // delay (ms)
-    POS _xy = { 0, 0 };  // current position
-    Stepper _x;          // X direction stepper
-    Stepper _y;          // Y direction stepper
-    AnalogButtons _abx;  // Interupts for X extremes
-    AnalogButtons _aby;  // Interupts for Y extremes
-    Pen _pen;            // Servo controller (pen up and down)
-    LiquidCrystal *_lcd; // LCD screen
-    bool _p = false;     // Print data
-
-    /**
-     * Private controller that does the actual moving
+    int _del;              // delay (ms)
+    POS _xy = { 0, 0 };    // position at the end of the queued moves
+    POS _pos = { 0, 0 };   // position of the steppers (set by the interrupt)
+    XStepper _x;           // X direction stepper
+    YStepper _y;           // Y direction stepper
+    Profile _rapidX;       // X speed limits with the pen up (moveTo)
+    Profile _rapidY;       // Y speed limits with the pen up (moveTo)
+    AnalogButtons _abx;    // Interupts for X extremes (read by the interrupt)
+    AnalogButtons _aby;    // Interupts for Y extremes (read by the interrupt)
+    Pen _pen;              // Servo controller (pen up and down)
+    Status _status;        // Position and mode on the LCD
+    Telemetry _telemetry;  // Binary position frames to Serial (print data)
+    unsigned int _count = 0; // Segments queued so far (next segment id)
+    unsigned long _moved = 0; // Last time we saw moves queued (ms)
+    void (*_onWait)() = NULL; // Run while waiting on room in the queue
+    bool _inWait = false;     // The wait hook is running
+
+    Planner _planner;      // Plans the speeds through the queued segments
+
+    // Step engine, only touched by the interrupt once started
+    SegmentQueue _queue;    // Moves waiting to be stepped out
+    Segment *_seg = NULL;   // Segment being stepped out
+    Ramp _ramp;             // Speed ramp of the current segment
+    unsigned long _wait = 0; // Timer ticks to the next step (over 16 bits under 8 steps/s)
+    volatile bool _trip = false; // Hit an extreme, waiting on run() to go home
+    int8_t _limitX = 0;     // X extreme switches as the last tick saw them
+    int8_t _limitY = 0;     // Y extreme switches as the last tick saw them
+    int8_t _sx = 0;         // Step to take in x on the next tick (1, -1, 0)
+    int8_t _sy = 0;         // Step to take in y on the next tick (1, -1, 0)
+    unsigned int _left = 0;  // Ticks left in the segment
+    unsigned int _major = 0; // Steps along the major (longer) axis
+    unsigned int _minor = 0; // Steps along the minor axis
+    unsigned int _acc = 0;   // Minor axis error accumulator (DDA)
+    bool _xMajor = true;     // x is the major axis
+    Arc _arc;                // Steps of the current arc (midpoint)
+
+    static Drive *_active; // Drive stepped by the timer interrupt
+
+    /**
+     * Private controller that queues the move
      * @param  x  New X position
      * @param  y  New Y position
      * @param  up Move pen up (true, dont draw) or down (false, draw)
@@ -43,6 +100,81 @@ private:
      */
     POS move(int x, int y, bool up);
 
+    /**
+     * Wait for room in the queue, servicing the Drive and running the wait
+     * hook (not from within it)
+     */
+    void room();
+
+    /**
+     * Fill the next free slot of the queue with a line from the end of the
+     * queued moves (check there is room first). Queue it with push().
+     * @param  x  New X position
+     * @param  y  New Y position
+     * @param  up Move pen up (true, dont draw) or down (false, draw)
+     * @return    Segment, NULL if there is no movement
+     */
+    Segment *fill(int x, int y, bool up);
+
+    /**
+     * Queue the filled segment, the interrupt picks it up from here
+     * @param  x New X position (the end of the segment)
+     * @param  y New Y position (the end of the segment)
+     * @return   The updated POS
+     */
+    POS push(int x, int y);
+
+    /**
+     * Length of a move, rounded to the nearest step
+     * @param  dx Steps along x
+     * @param  dy Steps along y
+     * @return    Length (steps)
+     */
+    unsigned int length(unsigned int dx, unsigned int dy);
+
+    /**
+     * Get the profile for a move, limited by the axes that move
+     * @param  x  Moving along x
+     * @param  y  Moving along y
+     * @param  up Pen up, use the rapid profiles
+     * @return    Profile
+     */
+    Profile profile(bool x, bool y, bool up);
+
+    /**
+     * Run a single timer tick (interrupt)
+     */
+    void tick();
+
+    /**
+     * Start stepping out a segment (interrupt)
+     * @param seg Segment from the queue
+     */
+    void begin(Segment *seg);
+
+    /**
+     * Work out the steps for the next tick and how long to wait (interrupt).
+     * Lines step the major axis every tick and the minor axis whenever its
+     * error accumulator rolls over (Bresenham), so both can step in the same
+     * tick. Arcs take whichever steps the midpoint Arc hands out.
+     */
+    void plan();
+
+    /**
+     * Step the axes planned for this tick (interrupt)
+     */
+    void pulse();
+
+    /**
+     * Load the timer with the next part of the wait (interrupt)
+     */
+    void arm();
+
+    /**
+     * Stop stepping and drop all queued moves
+     */
+    void stop();
+
 public:
     /**
      * Driver constructor (singleton)
@@ -87,12 +219,35 @@ public:
     );
 
     /**
-     * Used to setup Drive (call within setup())
+     * Used to setup Drive (call within setup()), starts the step timer
      */
     void attach();
 
     /**
-     * Draw a line from current POS to new POS
+     * Step timer interrupt handler, do not call
+     */
+    static void isr();
+
+    /**
+     * Service the Drive from the main loop: update the status display, send
+     * telemetry, check the extremes and power down idle steppers. Call often.
+     * @return true while there are moves left to step out
+     */
+    bool run();
+
+    /**
+     * Wait until every queued move has been stepped out
+     */
+    void sync();
+
+    /**
+     * Moves left to step out, or a tripped limit not homed from yet
+     * @return true/false
+     */
+    bool busy();
+
+    /**
+     * Queue a line from current POS to new POS
      * @param  x New X position
      * @param  y New Y position
      * @return   Updated POS
@@ -100,7 +255,20 @@ public:
     POS lineTo(int x, int y);
 
     /**
-     * Move the pen from current POS to new POS
+     * Queue a quarter ellipse from current POS to new POS, drawn step by
+     * step from the step interrupt. The ellipse is axis-aligned, centred on
+     * the corner of the box between the two points that the arc bends
+     * around.
+     * @param  x      New X position
+     * @param  y      New Y position
+     * @param  alongX Leave along x and arrive along y (true), or leave
+     *                along y and arrive along x (false)
+     * @return        Updated POS
+     */
+    POS arcTo(int x, int y, bool alongX);
+
+    /**
+     * Queue a move of the pen from current POS to new POS
      * @param  x New X position
      * @param  y New Y position
      * @return   Updated POS
@@ -108,19 +276,55 @@ public:
     POS moveTo(int x, int y);
 
     /**
-     * Return the pen to origin point (0,0)
+     * Return the pen to origin point (0,0), waits for queued moves first and
+     * for the pen to lift
      * @return Updated POS (0,0)
      */
     POS origin();
 
     /**
-     * Get the current POS
+     * Get the current POS, the end of the queued moves
      * @return POS, current position
      */
     POS get();
 
     /**
-     * Set the pen low point
+     * Set the speed limits of each axis while drawing (lineTo)
+     * @param x Profile for the X stepper
+     * @param y Profile for the Y stepper
+     */
+    void setProfile(Profile x, Profile y);
+
+    /**
+     * Set the speed limits of each axis with the pen up (moveTo). Until set
+     * these are the steppers' defaults.
+     * @param x Profile for the X stepper
+     * @param y Profile for the Y stepper
+     */
+    void setRapid(Profile x, Profile y);
+
+    /**
+     * Set a function run while a move waits on room in the queue, so the
+     * main loop's work (reading the client) goes on while a long shape is
+     * queued. It must not queue moves.
+     * @param wait Function, NULL for none
+     */
+    void setWait(void (*wait)());
+
+    /**
+     * Get the status display
+     * @return Status
+     */
+    Status *status();
+
+    /**
+     * Get the telemetry channel
+     * @return Telemetry
+     */
+    Telemetry *telemetry();
+
+    /**
+     * Set the pen low point, waits for queued moves first
      * @param ro read-out
      */
     int setPen(int ro);
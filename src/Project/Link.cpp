@@ -0,0 +1,220 @@
+/**
+ *  Link.cpp
+ *
+ *  Binary shape frames from the client. A frame carries any number of shapes,
+ *  is checked with a CRC and acknowledged once, instead of a ;next; round trip
+ *  for every token of the text protocol. The client keeps as many frames in
+ *  flight as the room in the shape table it was last sent allows.
+ *
+ *  @author Drew Sommer
+ *  @version 1.3.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Link.h"
+
+/**
+ * Add a byte to a CRC-16/XMODEM (poly 0x1021, starts at 0)
+ * @param  crc  CRC so far
+ * @param  data Byte
+ * @return      CRC
+ */
+uint16_t Link::crc(uint16_t crc, uint8_t data) {
+    crc ^= (uint16_t)data << 8;
+
+    for(uint8_t i = 0; i < 8; i++) {
+        crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+
+    return crc;
+};
+
+/**
+ * Receiver taking shapes into a shape table
+ * @param shapes Shape table
+ */
+Link::Link(ShapeTable *shapes):
+    _shapes(shapes) {};
+
+/**
+ * Acknowledge every frame taken in so far, with the room for more
+ */
+void Link::ack() {
+    _room = min(_shapes->room(), (size_t)LINK_CREDIT);
+
+    uart.print(F(";ack "));
+    uart.print((uint8_t)(_next - 1));
+    uart.print(F(" "));
+    uart.print(_room);
+    uart.println(F(";"));
+};
+
+/**
+ * Ask for the frames from the next one wanted again
+ */
+void Link::nak() {
+    uart.print(F(";nak "));
+    uart.print(_next);
+    uart.println(F(";"));
+};
+
+/**
+ * Take in bytes from the Uart until the frame is whole, never waits
+ */
+void Link::read() {
+
+    while(_state != LINK_READY && uart.available() > 0) {
+        uint8_t data = uart.read();
+
+        // A start is never inside a frame, so it always begins a new one.
+        // Whatever was cut short by lost bytes is dropped here.
+        if(data == LINK_START) {
+            _crc = 0;
+            _escape = false;
+            _state = LINK_SEQ;
+            continue;
+        }
+
+        if(_state == LINK_IDLE) continue;
+
+        // Escaped byte, the next one stands for a start or an escape
+        if(data == LINK_ESCAPE) {
+            _escape = true;
+            continue;
+        }
+        if(_escape) {
+            data ^= LINK_FLIP;
+            _escape = false;
+        }
+
+        switch(_state) {
+            case LINK_SEQ:
+                _seq = data;
+                _crc = crc(_crc, data);
+                _state = LINK_LEN;
+                break;
+
+            case LINK_LEN:
+                _len = data;
+                _got = 0;
+                _crc = crc(_crc, data);
+
+                // Can not be a frame, look for the next start
+                _state = _len == 0 || _len > LINK_PAYLOAD ? LINK_IDLE : LINK_DATA;
+                break;
+
+            case LINK_DATA:
+                _payload[_got++] = data;
+                _crc = crc(_crc, data);
+                if(_got == _len) _state = LINK_CRC_LO;
+                break;
+
+            case LINK_CRC_LO:
+                _check = data;
+                _state = LINK_CRC_HI;
+                break;
+
+            case LINK_CRC_HI:
+                _check |= (uint16_t)data << 8;
+
+                if(_check != _crc) {
+                    nak();
+                    _state = LINK_IDLE;
+
+                // Out of order. Ahead of the one wanted, one before it was
+                // corrupt or lost, ask for it again (the client goes back
+                // once). Behind, sent again as our ack was lost, ack it.
+                } else if(!_first && _seq != _next) {
+                    if((uint8_t)(_seq - _next) < 128) nak();
+                    else ack();
+                    _state = LINK_IDLE;
+
+                } else {
+                    _at = 0;
+                    _state = LINK_READY;
+                }
+                break;
+        }
+    }
+};
+
+/**
+ * Take the records of a whole frame into the shape table, as many as fit,
+ * and acknowledge the frame once they all have
+ * @return false while the frame is waiting on room in the table
+ */
+bool Link::take() {
+    if(_state != LINK_READY) return true;
+
+    while(_at < _len) {
+        uint8_t type = _payload[_at];
+        uint8_t *data = &_payload[_at + 1];
+        unsigned int n;
+        unsigned int deltas = 0;
+
+        if(type == LINK_END) {
+            _end = true;
+            _at++;
+            continue;
+        }
+
+        // Polygons give their point count, polylines the bytes of their
+        // deltas after the first point, the rest are known from the type
+        if(type == SHAPE_POLYGON) {
+            n = 2 * (unsigned int)*data++;
+        } else if(type == SHAPE_POLYLINE) {
+            deltas = *data++;
+            n = 2;
+        } else {
+            n = ShapeTable::values(type);
+        }
+
+        unsigned int size = data - &_payload[_at] + 2 * n + deltas;
+
+        // Unknown type or cut short, nothing after it can be read
+        if(n == 0 || _at + size > _len) {
+            uart.println(F("Bad frame"));
+            break;
+        }
+
+        // No room, try again once drawing has made some
+        if(!_shapes->add(type, type == SHAPE_POLYLINE ? deltas : n)) {
+
+            // Would not fit even on its own, drop it
+            if(_shapes->count() == 0) {
+                uart.println(F("Shape too big"));
+                _at += size;
+                continue;
+            }
+
+            return false;
+        }
+
+        for(unsigned int i = 0; i < n; i++) {
+            _shapes->set(i, (int16_t)(data[2*i] | data[2*i + 1] << 8));
+        }
+        if(deltas) _shapes->setDeltas(data + 2 * n, deltas);
+
+        _at += size;
+    }
+
+    _next = _seq + 1;
+    _first = false;
+    _state = LINK_IDLE;
+    ack();
+
+    return true;
+};
+
+/**
+ * Send the ack again once drawing has freed a frame's worth of room (or all
+ * the credit there is), or room for a whole frame where the last credit had
+ * none, so a client out of credit can carry on. Call often.
+ */
+void Link::update() {
+    if(_first || _end || _state != LINK_IDLE) return;
+
+    size_t room = min(_shapes->room(), (size_t)LINK_CREDIT);
+    if(room <= _room) return;
+
+    if(room >= _room + LINK_PAYLOAD || room == LINK_CREDIT || (_room < LINK_COST && room >= LINK_COST)) ack();
+};
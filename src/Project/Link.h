@@ -0,0 +1,182 @@
+/**
+ *  Link.h
+ *
+ *  Binary shape frames from the client. A frame carries any number of shapes,
+ *  is checked with a CRC and acknowledged once, instead of a ;next; round trip
+ *  for every token of the text protocol.
+ *
+ *  Frame (little endian):
+ *
+ *      0x7E seq len payload crc(uint16)
+ *
+ *  seq numbers the frames (mod 256), len is the payload size (1 to
+ *  LINK_PAYLOAD), crc is the CRC-16/XMODEM of seq, len and the payload. Any
+ *  0x7E or 0x7D after the start is sent as 0x7D then the byte XOR 0x20, so a
+ *  start only ever begins a frame and lost bytes cost one frame at most. The
+ *  payload is records one after the other, a type byte and int16 values:
+ *
+ *      SHAPE_CIRCLE  .. SHAPE_RAPID   values as in ShapeTable.h
+ *      SHAPE_POLYGON n x y x y ...    n (uint8) points
+ *      SHAPE_POLYLINE n x y deltas    n (uint8) bytes of deltas after the
+ *                                     first point (see Polyline.h)
+ *      LINK_END                       the list of shapes is complete
+ *
+ *  Replies (text lines):
+ *
+ *      ;ack seq room;  every frame up to seq is taken in (acks add up, one
+ *                      covers the frames before it), and room bytes of the
+ *                      shape table are free for the frames after it
+ *      ;nak seq;       a frame was corrupt or lost, send again from seq
+ *                      (the next frame wanted)
+ *
+ *  room is a credit: the client keeps sending frames, without waiting on
+ *  acks, as long as the records in the ones not acked take no more than
+ *  room. A record takes as many bytes in the table as in the frame, a
+ *  polygon or polyline one more (its count is an int there) and LINK_END
+ *  none. Frames within the credit always fit, so the line never idles for a
+ *  round trip. room is never more than LINK_CREDIT, and the client counts a
+ *  frame as its bytes on the wire when that is more, so the frames in flight
+ *  also always fit in the receive ring (see Uart.h) however long drawing
+ *  keeps the loop from reading them, at any baud.
+ *
+ *  While waiting on the client the ack is sent again whenever drawing has
+ *  freed another frame's worth of room, has freed all the credit there is,
+ *  or has made room for a whole frame (LINK_COST) after a credit too small
+ *  for one. A frame out of order is not taken in: one sent again is acked
+ *  with the last good one, one ahead of the frame wanted (after a corrupt
+ *  or lost one) is nak'd for it, the client going back once.
+ *
+ *  Until the first ack the client sends one frame at a time. If frames come
+ *  in over the credit the table may fill, then ;wait; is sent and the ack
+ *  held until there is room. 0x7E is never sent in the text protocol, so
+ *  both can share the port.
+ *
+ *  @author Drew Sommer
+ *  @version 1.3.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef LINK_H
+#define LINK_H
+#include "shapes/ShapeTable.h"
+#include "lib/Uart.h"
+#include <Arduino.h>
+
+// First byte of a frame
+#define LINK_START 0x7E
+
+// Escape for a LINK_START or LINK_ESCAPE inside a frame, sent before the
+// byte XOR LINK_FLIP
+#define LINK_ESCAPE 0x7D
+#define LINK_FLIP   0x20
+
+// Most payload bytes in a frame, small enough that any frame fits in the
+// credit (see below)
+#define LINK_PAYLOAD 48
+
+// Most shape table bytes the records of a frame take (polygons and
+// polylines, 6 bytes or more in a frame, take one more in the table)
+#define LINK_COST (LINK_PAYLOAD + LINK_PAYLOAD / 6)
+
+// Most credit sent with an ack, what the receive ring holds
+#define LINK_CREDIT (UART_RX_SIZE - 1)
+
+// A frame escaped all through (start, then seq, len, payload and crc at 2
+// bytes each) and a whole frame's records fit in the credit
+static_assert(1 + 2 * (LINK_PAYLOAD + 4) <= LINK_CREDIT, "Link: a frame may not fit in the receive ring");
+static_assert(LINK_COST <= LINK_CREDIT, "Link: a frame's records may not fit in the credit");
+
+// Record type for the end of the list of shapes
+#define LINK_END 0xFF
+
+// Receive states
+#define LINK_IDLE    0 // Waiting for LINK_START
+#define LINK_SEQ     1 // Waiting for seq
+#define LINK_LEN     2 // Waiting for len
+#define LINK_DATA    3 // Taking in the payload
+#define LINK_CRC_LO  4 // Waiting for the low byte of the crc
+#define LINK_CRC_HI  5 // Waiting for the high byte of the crc
+#define LINK_READY   6 // Whole frame in, being taken into the shape table
+
+/**
+ * Receiver for binary shape frames
+ */
+class Link {
+private:
+    uint8_t _payload[LINK_PAYLOAD]; // Payload of the frame
+    uint8_t _state = LINK_IDLE;     // Receive state
+    uint8_t _seq = 0;               // Number of the frame
+    uint8_t _len = 0;               // Payload bytes
+    uint8_t _got = 0;               // Payload bytes in so far
+    uint16_t _crc = 0;              // CRC of the frame so far
+    uint16_t _check = 0;            // CRC sent with the frame
+    uint8_t _at = 0;                // Next record to take in
+    uint8_t _next = 0;              // Number of the next new frame
+    bool _first = true;             // No frame taken in yet
+    bool _end = false;              // LINK_END taken in
+    bool _escape = false;           // Last byte was LINK_ESCAPE
+    ShapeTable *_shapes = NULL;     // Table the shapes are taken into
+    size_t _room = 0;               // Credit last sent with an ack
+
+    /**
+     * Acknowledge every frame taken in so far, with the room for more
+     */
+    void ack();
+
+    /**
+     * Ask for the frames from the next one wanted again
+     */
+    void nak();
+
+public:
+    /**
+     * Link()
+     */
+    Link(){};
+
+    /**
+     * Receiver taking shapes into a shape table
+     * @param shapes Shape table
+     */
+    Link(ShapeTable *shapes);
+
+    /**
+     * Add a byte to a CRC-16/XMODEM (poly 0x1021, starts at 0)
+     * @param  crc  CRC so far
+     * @param  data Byte
+     * @return      CRC
+     */
+    static uint16_t crc(uint16_t crc, uint8_t data);
+
+    /**
+     * In the middle of a frame, send the bytes from the Uart here
+     * @return true/false
+     */
+    bool busy(){ return _state != LINK_IDLE; };
+
+    /**
+     * Take in bytes from the Uart until the frame is whole, never waits
+     */
+    void read();
+
+    /**
+     * Take the records of a whole frame into the shape table, as many as fit,
+     * and acknowledge the frame once they all have
+     * @return false while the frame is waiting on room in the table
+     */
+    bool take();
+
+    /**
+     * Send the ack again once drawing has freed a frame's worth of room (or
+     * all the credit there is), or room for a whole frame where the last
+     * credit had none, so a client out of credit can carry on. Call often.
+     */
+    void update();
+
+    /**
+     * The list of shapes is complete
+     * @return true/false
+     */
+    bool end(){ return _end; };
+};
+
+#endif
@@ -0,0 +1,162 @@
+/**
+ *  Parser.cpp
+ *
+ *  Text shape commands from the client, taken in a byte at a time by a state
+ *  machine that never waits. Whole shapes are added to the shape table.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Parser.h"
+#include "Link.h"
+
+/**
+ * Parser adding shapes to a shape table
+ * @param shapes Shape table
+ */
+Parser::Parser(ShapeTable *shapes):
+    _shapes(shapes) {};
+
+/**
+ * Ask the client for the next token
+ */
+void Parser::next() {
+    uart.println(F(";next;"));
+};
+
+/**
+ * Take in bytes from the Uart until a shape is in, never waits. Stops at a
+ * LINK_START, frames are read by the Link.
+ */
+void Parser::read() {
+    while(_state != PARSER_READY && uart.available() > 0 && uart.peek() != LINK_START) {
+        parse((char)uart.read());
+    }
+};
+
+/**
+ * Act on a byte
+ * @param c Byte
+ */
+void Parser::parse(char c) {
+    switch(_state) {
+        case PARSER_COMMAND:
+            if(c == 'n') {
+                next();
+            } else if(c == 'p') {
+                _state = PARSER_TYPE;
+                next();
+            } else if(c == 'u') {
+                _end = true;
+            }
+            break;
+
+        case PARSER_TYPE:
+            _type = c;
+            _n = 0;
+            _value = 0;
+            _digits = false;
+            _negative = false;
+            _state = PARSER_VALUE;
+            next();
+            break;
+
+        case PARSER_VALUE:
+            if(c >= '0' && c <= '9') {
+                // Past the int16 limits more digits change nothing
+                if(_value <= 32768) _value = _value * 10 + (c - '0');
+                _digits = true;
+
+            } else if(c == '-' && !_digits) {
+                _negative = true;
+
+            // End of a value, those past PARSER_VALUES (more than the shape
+            // takes) are dropped
+            } else if(c == ';') {
+                if(_negative) _value = -_value;
+                if(_n < PARSER_VALUES) _values[_n++] = constrain(_value, -32768, 32767);
+
+                _value = 0;
+                _digits = false;
+                _negative = false;
+
+                // Polygon too long to hold, add what is in as a piece
+                if(_type == 'P' && _n == PARSER_VALUES) {
+                    _piece = true;
+                    _state = PARSER_READY;
+                } else {
+                    next();
+                }
+
+            } else if(c == 'q') {
+                _piece = false;
+                _state = PARSER_READY;
+            }
+            break;
+    }
+};
+
+/**
+ * SHAPE_ type of the shape in, from its letter and values
+ * @return Type, 0 if it is not a shape
+ */
+uint8_t Parser::type() {
+    switch(_type) {
+        case 'C': return SHAPE_CIRCLE;
+        case 'E': return _n > 4 ? SHAPE_ROTATED : SHAPE_ELLIPSE; // With a rotation
+        case 'B': return SHAPE_BEZIER;
+        case 'P': return SHAPE_POLYGON;
+        case 'F': return SHAPE_FEED;
+        case 'R': return SHAPE_RAPID;
+    }
+    return 0;
+};
+
+/**
+ * Add a shape that is in to the shape table, and ask for the next token
+ * @return false while the shape is waiting on room in the table
+ */
+bool Parser::take() {
+    if(_state != PARSER_READY) return true;
+
+    uint8_t type = this->type();
+    unsigned int n = _n;
+
+    // Polygons take any number of points, the rest a set number of values
+    // (0 for an unknown type)
+    if(type == SHAPE_POLYGON) n -= n % 2;
+    else if(n >= ShapeTable::values(type)) n = ShapeTable::values(type);
+    else n = 0;
+
+    if(n == 0) {
+        uart.println(F("Bad shape"));
+
+    } else if(_shapes->add(type, n)) {
+        for(unsigned int i = 0; i < n; i++) {
+            _shapes->set(i, _values[i]);
+        }
+
+    // No room, try again once drawing has made some
+    } else if(_shapes->count() > 0) {
+        return false;
+
+    // Would not fit even on its own, drop it
+    } else {
+        uart.println(F("Shape too big"));
+    }
+
+    // The rest of the polygon carries on from the last point
+    if(_piece) {
+        _values[0] = _values[_n - 2];
+        _values[1] = _values[_n - 1];
+        _n = 2;
+        _piece = false;
+        _state = PARSER_VALUE;
+    } else {
+        _state = PARSER_COMMAND;
+    }
+
+    next();
+    return true;
+};
@@ -0,0 +1,115 @@
+/**
+ *  Parser.h
+ *
+ *  Text shape commands from the client (the protocol in main.cpp), taken in a
+ *  byte at a time as they come. Each byte moves a small state machine on, so
+ *  it never waits for the rest of a token, and numbers are built up digit by
+ *  digit. A whole shape is added to the shape table, the queue drawing takes
+ *  them from.
+ *
+ *  Tokens:
+ *
+ *      n           connected, ;next; is sent
+ *      p           a shape comes next
+ *      C E B P F R type of the shape (see main.cpp)
+ *      -123;       a value, any number of digits (held at the int16 limits)
+ *      q           end of the shape, it is added to the shape table
+ *      u           the list of shapes is complete
+ *
+ *  ;next; is sent once each token is in (once the shape is added, for q),
+ *  the client sends one token for each. Bytes that are not part of a token
+ *  are skipped. A polygon longer than PARSER_VALUES is added in pieces, each
+ *  starting from the last point of the one before, so polygons of any length
+ *  take no more memory here.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef PARSER_H
+#define PARSER_H
+#include "shapes/ShapeTable.h"
+#include "lib/Uart.h"
+#include <Arduino.h>
+
+// Most values of a shape held at once, polygons past this are added in
+// pieces (even, and at least SHAPE_VALUES)
+#define PARSER_VALUES 16
+
+// Receive states
+#define PARSER_COMMAND 0 // Waiting for n, p or u
+#define PARSER_TYPE    1 // Waiting for the type of the shape
+#define PARSER_VALUE   2 // Taking in values, up to q
+#define PARSER_READY   3 // Shape (or polygon piece) in, being added to the table
+
+/**
+ * Parser for the text shape commands
+ */
+class Parser {
+private:
+    int16_t _values[PARSER_VALUES];  // Values of the shape so far
+    uint8_t _n = 0;                  // Values in _values
+    uint8_t _state = PARSER_COMMAND; // Receive state
+    char _type = 0;                  // Type letter of the shape
+    long _value = 0;                 // Value being built, digit by digit
+    bool _digits = false;            // The value has a digit
+    bool _negative = false;          // The value started with '-'
+    bool _piece = false;             // The shape in is a piece of a polygon
+    bool _end = false;               // u taken in
+    ShapeTable *_shapes = NULL;      // Table the shapes are added to
+
+    /**
+     * Ask the client for the next token
+     */
+    void next();
+
+    /**
+     * Act on a byte
+     * @param c Byte
+     */
+    void parse(char c);
+
+    /**
+     * SHAPE_ type of the shape in, from its letter and values
+     * @return Type, 0 if it is not a shape
+     */
+    uint8_t type();
+
+public:
+    /**
+     * Parser()
+     */
+    Parser(){};
+
+    /**
+     * Parser adding shapes to a shape table
+     * @param shapes Shape table
+     */
+    Parser(ShapeTable *shapes);
+
+    /**
+     * In the middle of a shape
+     * @return true/false
+     */
+    bool busy(){ return _state != PARSER_COMMAND; };
+
+    /**
+     * Take in bytes from the Uart until a shape is in, never waits. Stops at
+     * a LINK_START, frames are read by the Link.
+     */
+    void read();
+
+    /**
+     * Add a shape that is in to the shape table, and ask for the next token
+     * @return false while the shape is waiting on room in the table
+     */
+    bool take();
+
+    /**
+     * The list of shapes is complete
+     * @return true/false
+     */
+    bool end(){ return _end; };
+};
+
+#endif
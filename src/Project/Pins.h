@@ -0,0 +1,24 @@
+/**
+ *  Pins.h
+ *
+ *  Pins of the steppers. Used by the PinMap's in main.cpp and by the
+ *  compile-time steppers in Drive.h, so the two always agree.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef PINS_H
+#define PINS_H
+
+// X stepper (EasyDriver)
+#define X_STEP_PIN   4
+#define X_DIR_PIN    2
+#define X_ENABLE_PIN 3
+
+// Y stepper (EasyDriver)
+#define Y_STEP_PIN   7
+#define Y_DIR_PIN    5
+#define Y_ENABLE_PIN 6
+
+#endif
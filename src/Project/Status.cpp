@@ -0,0 +1,104 @@
+/**
+ *  Status.cpp
+ *
+ *  Status display, owns the position and mode shown on the LCD.
+ *  Every LCD byte takes ~40us over the shift register, so nothing writes the
+ *  position while stepping. The Drive and main loop only update the values
+ *  here, update() redraws what changed at most every STATUS_INTERVAL.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Status.h"
+
+/**
+ * Status on an LCD
+ * @param lcd LCD controller
+ */
+Status::Status(LiquidCrystal *lcd): _lcd(lcd){};
+
+/**
+ * Set the position to show
+ * @param pos Position
+ */
+void Status::setPOS(POS pos) {
+    if(pos.x != _pos.x || pos.y != _pos.y) {
+        _pos = pos;
+        _redraw = true;
+    }
+};
+
+/**
+ * Set the mode to show on the second line
+ * @param mode Text in flash, F("...") (kept, not copied)
+ */
+void Status::setMode(const __FlashStringHelper *mode) {
+    _mode = mode;
+};
+
+/**
+ * Redraw what changed if the interval has passed, call from the main loop
+ * @return true if anything was drawn
+ */
+bool Status::update() {
+    if(!_redraw && _mode == _modeShown) return false;
+    if(millis() - _drawn < STATUS_INTERVAL) return false;
+
+    flush();
+    return true;
+};
+
+/**
+ * Redraw what changed now
+ */
+void Status::flush() {
+    _drawn = millis();
+
+    if(_mode != _modeShown) {
+        _modeShown = _mode;
+
+        _lcd->setCursor(0,1);
+        uint8_t n = _mode != NULL ? _lcd->print(_mode) : 0;
+        while(n++ < 16) _lcd->print(' ');
+    }
+
+    if(_redraw) {
+        _redraw = false;
+
+        // Print current position to LCD, only blank what the last one used
+        _lcd->setCursor(0,0);
+        uint8_t n = _lcd->print('(');
+        n += _lcd->print(_pos.x);
+        n += _lcd->print(',');
+        n += _lcd->print(_pos.y);
+        n += _lcd->print(')');
+        for(uint8_t i = n; i < _width; i++) _lcd->print(' ');
+        _width = n;
+    }
+};
+
+/**
+ * Something else drew over the LCD, draw everything again on the next
+ * update()
+ */
+void Status::invalidate() {
+    _modeShown = NULL;
+    _width = 16;
+    _redraw = true;
+};
+
+/**
+ * Bytes sent to the LCD since the last reset() (by anyone)
+ * @return writes
+ */
+unsigned long Status::writes() {
+    return _lcd->writes();
+};
+
+/**
+ * Reset the LCD write counter, call at the start of a job
+ */
+void Status::reset() {
+    _lcd->resetWrites();
+};
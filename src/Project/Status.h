@@ -0,0 +1,83 @@
+/**
+ *  Status.h
+ *
+ *  Status display, owns the position and mode shown on the LCD.
+ *  Every LCD byte takes ~40us over the shift register, so nothing writes the
+ *  position while stepping. The Drive and main loop only update the values
+ *  here, update() redraws what changed at most every STATUS_INTERVAL.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef STATUS_H
+#define STATUS_H
+#include "stepper/POS.h"
+#include "lib/ShiftedLCD.h"
+#include <Arduino.h>
+
+// Time between redraws (ms), 5Hz
+#define STATUS_INTERVAL 200
+
+/**
+ * Rate limited status display, position on the first line, mode on the second
+ */
+class Status {
+private:
+    LiquidCrystal *_lcd;           // LCD screen
+    POS _pos = { 0, 0 };           // Position to show
+    const __FlashStringHelper *_mode = NULL;      // Mode to show (in flash)
+    const __FlashStringHelper *_modeShown = NULL; // Mode last drawn
+    uint8_t _width = 0;            // Chars of the position last drawn
+    bool _redraw = true;           // Position needs drawing
+    unsigned long _drawn = 0;      // Last redraw (ms)
+
+public:
+    /**
+     * Status on an LCD
+     * @param lcd LCD controller
+     */
+    Status(LiquidCrystal *lcd);
+
+    /**
+     * Set the position to show
+     * @param pos Position
+     */
+    void setPOS(POS pos);
+
+    /**
+     * Set the mode to show on the second line
+     * @param mode Text in flash, F("...") (kept, not copied)
+     */
+    void setMode(const __FlashStringHelper *mode);
+
+    /**
+     * Redraw what changed if the interval has passed, call from the main loop
+     * @return true if anything was drawn
+     */
+    bool update();
+
+    /**
+     * Redraw what changed now
+     */
+    void flush();
+
+    /**
+     * Something else drew over the LCD, draw everything again on the next
+     * update()
+     */
+    void invalidate();
+
+    /**
+     * Bytes sent to the LCD since the last reset() (by anyone)
+     * @return writes
+     */
+    unsigned long writes();
+
+    /**
+     * Reset the LCD write counter, call at the start of a job
+     */
+    void reset();
+};
+
+#endif
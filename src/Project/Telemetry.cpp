@@ -0,0 +1,93 @@
+/**
+ *  Telemetry.cpp
+ *
+ *  Binary telemetry for the client. Frames (position, segment and queue
+ *  depth) are kept in a small ring buffer and only written to Serial while
+ *  the UART has room for a whole frame, so sending them never blocks. When
+ *  the UART cannot keep up the oldest frame is dropped.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Telemetry.h"
+
+/**
+ * Telemetry()
+ * @param on Record frames (the Drive's print flag)
+ */
+Telemetry::Telemetry(bool on): _on(on) {
+    _last.depth = 0xFF; // Nothing recorded yet, first record() always counts
+};
+
+/**
+ * Record a frame if anything changed since the last one, drops the
+ * oldest frame when full
+ * @param pos     Position of the steppers
+ * @param segment Segment being stepped out
+ * @param depth   Segments queued
+ */
+void Telemetry::record(POS pos, unsigned int segment, uint8_t depth) {
+    if(!_on) return;
+
+    if(pos.x == _last.pos.x && pos.y == _last.pos.y &&
+       segment == _last.segment && depth == _last.depth) return;
+
+    _last.seq = _seq++;
+    _last.pos = pos;
+    _last.segment = segment;
+    _last.depth = depth;
+
+    uint8_t next = (_head + 1) & (TELEMETRY_SIZE - 1);
+
+    // Full, make room by dropping the oldest frame
+    if(next == _tail) {
+        _tail = (_tail + 1) & (TELEMETRY_SIZE - 1);
+        _dropped++;
+    }
+
+    _buffer[_head] = _last;
+    _head = next;
+};
+
+/**
+ * Write frames while the UART has room for them, never waits
+ * @return Frames written
+ */
+uint8_t Telemetry::drain() {
+    uint8_t sent = 0;
+    uint8_t out[TELEMETRY_FRAME];
+
+    while(_tail != _head && uart.availableForWrite() >= TELEMETRY_FRAME) {
+        Frame *f = &_buffer[_tail];
+
+        out[0] = TELEMETRY_START;
+        out[1] = f->seq;
+        out[2] = f->pos.x & 0xFF;
+        out[3] = (f->pos.x >> 8) & 0xFF;
+        out[4] = f->pos.y & 0xFF;
+        out[5] = (f->pos.y >> 8) & 0xFF;
+        out[6] = f->segment & 0xFF;
+        out[7] = (f->segment >> 8) & 0xFF;
+        out[8] = f->depth;
+
+        uint8_t sum = 0;
+        for(uint8_t i = 1; i < TELEMETRY_FRAME - 1; i++) sum += out[i];
+        out[9] = sum;
+
+        uart.write(out, TELEMETRY_FRAME);
+
+        _tail = (_tail + 1) & (TELEMETRY_SIZE - 1);
+        sent++;
+    }
+
+    return sent;
+};
+
+/**
+ * Frames dropped because the UART could not keep up
+ * @return dropped
+ */
+unsigned long Telemetry::dropped() {
+    return _dropped;
+};
@@ -0,0 +1,88 @@
+/**
+ *  Telemetry.h
+ *
+ *  Binary telemetry for the client. Frames (position, segment and queue
+ *  depth) are kept in a small ring buffer and only written to Serial while
+ *  the UART has room for a whole frame, so sending them never blocks. When
+ *  the UART cannot keep up the oldest frame is dropped.
+ *
+ *  Frame (10 bytes, little endian):
+ *
+ *      0xA5 seq x(int16) y(int16) segment(uint16) depth(uint8) sum
+ *
+ *  seq counts every frame recorded (gaps are dropped frames), sum is the
+ *  8 bit sum of seq through depth. 0xA5 is never sent in text, so the client
+ *  can pick the frames out of the normal uart.print() output.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+#include "stepper/POS.h"
+#include "lib/Uart.h"
+#include <Arduino.h>
+
+// Frames held waiting for the UART (power of 2)
+#define TELEMETRY_SIZE 4
+
+// First byte of a frame
+#define TELEMETRY_START 0xA5
+
+// Bytes in a frame
+#define TELEMETRY_FRAME 10
+
+/**
+ * Telemetry sample
+ */
+struct Frame {
+    uint8_t seq;          // Frame number
+    POS pos;              // Position of the steppers
+    unsigned int segment; // Segment being stepped out (or the last one)
+    uint8_t depth;        // Segments queued
+};
+
+/**
+ * Drop-oldest ring buffer of telemetry frames drained to Serial
+ */
+class Telemetry {
+private:
+    Frame _buffer[TELEMETRY_SIZE]; // Frames waiting to be sent
+    uint8_t _head = 0;             // Next free slot
+    uint8_t _tail = 0;             // Oldest frame
+    uint8_t _seq = 0;              // Number of the next frame
+    Frame _last;                   // Last frame recorded
+    bool _on = false;              // Record frames
+    unsigned long _dropped = 0;    // Frames dropped because the UART was busy
+
+public:
+    /**
+     * Telemetry()
+     * @param on Record frames (the Drive's print flag)
+     */
+    Telemetry(bool on);
+
+    /**
+     * Record a frame if anything changed since the last one, drops the
+     * oldest frame when full
+     * @param pos     Position of the steppers
+     * @param segment Segment being stepped out
+     * @param depth   Segments queued
+     */
+    void record(POS pos, unsigned int segment, uint8_t depth);
+
+    /**
+     * Write frames while the UART has room for them, never waits
+     * @return Frames written
+     */
+    uint8_t drain();
+
+    /**
+     * Frames dropped because the UART could not keep up
+     * @return dropped
+     */
+    unsigned long dropped();
+};
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ *  Fixed.cpp
+ *
+ *  Q16.16 fixed point number for the shape and motion math. The Uno has no
+ *  FPU, every float multiply, sqrt, pow and sin is a software routine of
+ *  hundreds to thousands of cycles. Fixed only needs integer adds, 16x16 bit
+ *  multiplies and shifts.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Fixed.h"
+
+/**
+ * Square root one bit at a time (no multiplies), takes two bits of n per bit
+ * of the result and then frac more pairs of zero bits
+ * @param  n    Integer
+ * @param  frac Fraction bits wanted (8 at most)
+ * @return      floor(sqrt(n) * 2^frac)
+ */
+static uint32_t sqrtBits(uint32_t n, uint8_t frac) {
+    uint32_t rem = 0;
+    uint32_t root = 0;
+
+    for(uint8_t i = 0; i < 16 + frac; i++) {
+
+        // Bring down the next two bits
+        rem = (rem << 2) | (n >> 30);
+        n <<= 2;
+
+        // Next bit is 1 if (2 * root + 1) still fits in the remainder
+        root <<= 1;
+        uint32_t test = (root << 1) | 1;
+        if(rem >= test) {
+            rem -= test;
+            root |= 1;
+        }
+    }
+
+    return root;
+};
+
+/**
+ * Convert degrees to radians
+ * @param  deg Angle (degrees)
+ * @return     Angle (radians)
+ */
+Fixed Fixed::fromDegrees(int deg) {
+    return fromRaw((int32_t)deg * FIXED_PI.raw / 180);
+};
+
+/**
+ * Multiply. Split into 16 bit halves so every partial product is a 16x16
+ * multiply, which the AVR does in hardware
+ *   a * b = (ah * 2^16 + al) * (bh * 2^16 + bl) / 2^16
+ * @param  b Value
+ * @return   this * b
+ */
+Fixed Fixed::operator*(Fixed b) const {
+    int16_t ah = raw >> 16;
+    uint16_t al = raw & 0xFFFF;
+    int16_t bh = b.raw >> 16;
+    uint16_t bl = b.raw & 0xFFFF;
+
+    // Unsigned sum so the parts may wrap, the total is right if it fits
+    uint32_t r = (uint32_t)((int32_t)ah * bh) << 16;
+    r += (uint32_t)((int32_t)ah * bl);
+    r += (uint32_t)((int32_t)bh * al);
+    r += ((uint32_t)al * bl + 0x8000) >> 16;
+
+    return fromRaw((int32_t)r);
+};
+
+/**
+ * Divide by long division, one bit of the result at a time. Saturates when
+ * the result is out of range or b is 0.
+ * @param  b Value
+ * @return   this / b
+ */
+Fixed Fixed::operator/(Fixed b) const {
+    bool neg = (raw < 0) != (b.raw < 0);
+    uint32_t rem = raw < 0 ? -(uint32_t)raw : raw;
+    uint32_t div = b.raw < 0 ? -(uint32_t)b.raw : b.raw;
+
+    if(div == 0) return fromRaw(neg ? FIXED_MIN : FIXED_MAX);
+
+    uint32_t quot = 0;
+    uint32_t bit = FIXED_ONE;
+
+    // Line the divisor up with the remainder
+    while(div < rem) {
+        div <<= 1;
+        bit <<= 1;
+    }
+
+    // Integer part does not fit
+    if(bit == 0) return fromRaw(neg ? FIXED_MIN : FIXED_MAX);
+
+    // Top bit set, do one step by hand so the remainder can not overflow
+    if(div & 0x80000000UL) {
+        if(rem >= div) {
+            quot |= bit;
+            rem -= div;
+        }
+        div >>= 1;
+        bit >>= 1;
+    }
+
+    while(bit != 0 && rem != 0) {
+        if(rem >= div) {
+            quot |= bit;
+            rem -= div;
+        }
+        rem <<= 1;
+        bit >>= 1;
+    }
+
+    // Round the last bit
+    if(rem >= div) quot++;
+
+    if(quot > (uint32_t)FIXED_MAX) return fromRaw(neg ? FIXED_MIN : FIXED_MAX);
+
+    return fromRaw(neg ? -(int32_t)quot : (int32_t)quot);
+};
+
+/**
+ * Square root, negative values give 0
+ * @param  x Value
+ * @return   sqrt(x)
+ */
+Fixed Fixed::sqrt(Fixed x) {
+    if(x.raw <= 0) return Fixed();
+
+    // sqrt(raw * 2^16) = sqrt(x) * 2^16
+    return fromRaw(sqrtBits(x.raw, 8));
+};
+
+/**
+ * Square root of an integer, to 1/256
+ * @param  n Integer (less than 2^30)
+ * @return   sqrt(n)
+ */
+Fixed Fixed::root(unsigned long n) {
+    return fromRaw(sqrtBits(n, 8) << 8);
+};
+
+/**
+ * Integer square root
+ * @param  n Integer
+ * @return   floor(sqrt(n))
+ */
+unsigned long Fixed::isqrt(unsigned long n) {
+    return sqrtBits(n, 0);
+};
+
+/**
+ * Sine
+ * @param  a Angle (radians)
+ * @return   sin(a)
+ */
+Fixed Fixed::sin(Fixed a) {
+
+    // Bring the angle into -pi to pi
+    a.raw %= FIXED_TWO_PI.raw;
+    if(a > FIXED_PI) a -= FIXED_TWO_PI;
+    if(a < -FIXED_PI) a += FIXED_TWO_PI;
+
+    // Then into -pi/2 to pi/2, sin(pi - a) = sin(a)
+    if(a > FIXED_HALF_PI) a = FIXED_PI - a;
+    if(a < -FIXED_HALF_PI) a = -FIXED_PI - a;
+
+    // Taylor series to x^9 over -pi/2 to pi/2, within ~4e-5 after rounding
+    //   sin(x) = x(1 - x^2/6(1 - x^2/20(1 - x^2/42(1 - x^2/72))))
+    Fixed x2 = a * a;
+    Fixed r = Fixed(1) - x2 * fromRaw((FIXED_ONE + 36) / 72);
+    r = Fixed(1) - x2 * fromRaw((FIXED_ONE + 21) / 42) * r;
+    r = Fixed(1) - x2 * fromRaw((FIXED_ONE + 10) / 20) * r;
+    r = Fixed(1) - x2 * fromRaw((FIXED_ONE + 3) / 6) * r;
+
+    return a * r;
+};
+
+/**
+ * Cosine
+ * @param  a Angle (radians)
+ * @return   cos(a)
+ */
+Fixed Fixed::cos(Fixed a) {
+    return sin(a + FIXED_HALF_PI);
+};
+
+/**
+ * Scale an integer, saturates instead of overflowing
+ * @param  n Integer
+ * @param  f Scale (not negative)
+ * @return   floor(n * f)
+ */
+unsigned long Fixed::scale(unsigned long n, Fixed f) {
+    if(f.raw <= 0) return 0;
+
+    uint32_t whole = (uint32_t)f.raw >> 16;
+    uint32_t frac = (uint32_t)f.raw & 0xFFFF;
+
+    // n * whole
+    if(whole != 0 && n > 0xFFFFFFFFUL / whole) return 0xFFFFFFFFUL;
+    uint32_t r = n * whole;
+
+    // n * frac / 2^16, split so it can not overflow
+    uint32_t part = (n >> 16) * frac + (((n & 0xFFFF) * frac) >> 16);
+    if(r > 0xFFFFFFFFUL - part) return 0xFFFFFFFFUL;
+
+    return r + part;
+};
@@ -0,0 +1,145 @@
+/**
+ *  Fixed.h
+ *
+ *  Q16.16 fixed point number for the shape and motion math. The Uno has no
+ *  FPU, every float multiply, sqrt, pow and sin is a software routine of
+ *  hundreds to thousands of cycles. Fixed only needs integer adds, 16x16 bit
+ *  multiplies and shifts.
+ *
+ *  Range is -32768 to 32767.99998 with a resolution of 1/65536. Nothing
+ *  saturates except division, keep values (and products) in range.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef FIXED_H
+#define FIXED_H
+#include <stdint.h>
+
+// 1.0 as a raw value
+#define FIXED_ONE 65536L
+
+// Largest and smallest raw values
+#define FIXED_MAX 0x7FFFFFFFL
+#define FIXED_MIN (-FIXED_MAX - 1)
+
+/**
+ * Q16.16 fixed point number
+ */
+class Fixed {
+public:
+    int32_t raw; // value * 65536
+
+    /**
+     * Fixed(), zero
+     */
+    Fixed(): raw(0){};
+
+    /**
+     * Fixed from an integer
+     * @param n Integer (-32768 to 32767)
+     */
+    Fixed(int n): raw((int32_t)n * FIXED_ONE){};
+
+    /**
+     * Fixed from a raw value
+     * @param  raw value * 65536
+     * @return     Fixed
+     */
+    static Fixed fromRaw(int32_t raw){ Fixed f; f.raw = raw; return f; };
+
+    /**
+     * Fixed from a fraction
+     * @param  num Numerator
+     * @param  den Denominator
+     * @return     num / den
+     */
+    static Fixed ratio(int num, int den){ return Fixed(num) / Fixed(den); };
+
+    /**
+     * Convert degrees to radians
+     * @param  deg Angle (degrees)
+     * @return     Angle (radians)
+     */
+    static Fixed fromDegrees(int deg);
+
+    /**
+     * Round to the nearest integer
+     * @return int
+     */
+    int toInt() const { return (int)((raw + FIXED_ONE / 2) >> 16); };
+
+    /**
+     * Round down to an integer
+     * @return int
+     */
+    int floor() const { return (int)(raw >> 16); };
+
+    Fixed operator+(Fixed b) const { return fromRaw(raw + b.raw); };
+    Fixed operator-(Fixed b) const { return fromRaw(raw - b.raw); };
+    Fixed operator-() const { return fromRaw(-raw); };
+    Fixed operator*(Fixed b) const;
+    Fixed operator/(Fixed b) const;
+
+    Fixed &operator+=(Fixed b){ raw += b.raw; return *this; };
+    Fixed &operator-=(Fixed b){ raw -= b.raw; return *this; };
+    Fixed &operator*=(Fixed b){ *this = *this * b; return *this; };
+
+    bool operator==(Fixed b) const { return raw == b.raw; };
+    bool operator!=(Fixed b) const { return raw != b.raw; };
+    bool operator<(Fixed b) const { return raw < b.raw; };
+    bool operator>(Fixed b) const { return raw > b.raw; };
+    bool operator<=(Fixed b) const { return raw <= b.raw; };
+    bool operator>=(Fixed b) const { return raw >= b.raw; };
+
+    /**
+     * Square root, negative values give 0
+     * @param  x Value
+     * @return   sqrt(x)
+     */
+    static Fixed sqrt(Fixed x);
+
+    /**
+     * Square root of an integer, to 1/256
+     * @param  n Integer (less than 2^30)
+     * @return   sqrt(n)
+     */
+    static Fixed root(unsigned long n);
+
+    /**
+     * Integer square root
+     * @param  n Integer
+     * @return   floor(sqrt(n))
+     */
+    static unsigned long isqrt(unsigned long n);
+
+    /**
+     * Sine
+     * @param  a Angle (radians)
+     * @return   sin(a)
+     */
+    static Fixed sin(Fixed a);
+
+    /**
+     * Cosine
+     * @param  a Angle (radians)
+     * @return   cos(a)
+     */
+    static Fixed cos(Fixed a);
+
+    /**
+     * Scale an integer, saturates instead of overflowing
+     * @param  n Integer
+     * @param  f Scale (not negative)
+     * @return   floor(n * f)
+     */
+    static unsigned long scale(unsigned long n, Fixed f);
+};
+
+// Constants
+#define FIXED_PI      Fixed::fromRaw(205887L) // pi
+#define FIXED_HALF_PI Fixed::fromRaw(102944L) // pi / 2
+#define FIXED_TWO_PI  Fixed::fromRaw(411775L) // 2 pi
+
+#endif
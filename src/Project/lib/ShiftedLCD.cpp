@@ -37,6 +37,7 @@ void LiquidCrystal::initSPI(uint8_t ssPin) //SPI ###############################
     // initialize SPI:
 
 	_latchPin = ssPin;
+	_writes = 0;
 	pinMode (_latchPin, OUTPUT); //just in case _latchPin is not 10 or 53 set it to output 
 								 //otherwise SPI.begin() will set it to output but just in case
 		
@@ -56,6 +57,7 @@ void LiquidCrystal::initSPI(uint8_t ssPin) //SPI ###############################
 }
 
 void LiquidCrystal::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
+  (void)cols; // Any width, the DDRAM addresses are set by setCursor()
   if (lines > 1) {
     _displayfunction |= LCD_2LINE;
   }
@@ -236,6 +238,7 @@ inline size_t LiquidCrystal::write(uint8_t value) {
 
 // write either command or data, with automatic 4/8-bit selection
 void LiquidCrystal::send(uint8_t value, uint8_t mode) {
+    _writes++;
     bitWrite(_bitString, 1, mode); //set RS to mode
     spiSendOut();    
 	//we are not using RW with SPI so we are not even bothering
@@ -244,6 +247,15 @@ void LiquidCrystal::send(uint8_t value, uint8_t mode) {
     write4bits(value);    
 }
 
+// bytes sent to the LCD since the last resetWrites(), each one costs ~40us
+unsigned long LiquidCrystal::writes() {
+  return _writes;
+}
+
+void LiquidCrystal::resetWrites() {
+  _writes = 0;
+}
+
 void LiquidCrystal::pulseEnable(void) {
     bitWrite(_bitString, 3, LOW); 
     spiSendOut();
@@ -73,6 +73,9 @@ public:
   void setCursor(uint8_t, uint8_t); 
   virtual size_t write(uint8_t);
   void command(uint8_t);
+
+  unsigned long writes(); // bytes sent to the LCD (chars and commands)
+  void resetWrites();
 private:
   void send(uint8_t, uint8_t);
   void spiSendOut();      // SPI ###########################################
@@ -93,6 +96,8 @@ private:
   uint8_t _initialized;
 
   uint8_t _numlines,_currline;
+
+  unsigned long _writes; // bytes sent since the last resetWrites()
 };
 
 #endif
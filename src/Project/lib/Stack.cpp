@@ -0,0 +1,45 @@
+/**
+ *  Stack.cpp
+ *
+ *  How deep the stack has gone, from the paint it has not overwritten.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Stack.h"
+
+// End of the globals, and the end of the heap once anything is allocated
+// (avr-libc)
+extern char __heap_start;
+extern char *__brkval;
+
+/**
+ * Lowest byte the stack can reach
+ * @return Address
+ */
+static uint8_t *bottom() {
+    return (uint8_t *)(__brkval != NULL ? __brkval : &__heap_start);
+};
+
+/**
+ * Paint the RAM between the heap and the stack (call first in setup())
+ */
+void Stack::paint() {
+    uint8_t *top = (uint8_t *)SP; // Next byte the stack pushes to
+
+    for(uint8_t *at = bottom(); at < top; at++) *at = STACK_PAINT;
+};
+
+/**
+ * Bytes of the paint the stack has never reached
+ * @return Bytes
+ */
+size_t Stack::unused() {
+    uint8_t *top = (uint8_t *)SP;
+    uint8_t *at = bottom();
+
+    while(at < top && *at == STACK_PAINT) at++;
+
+    return at - bottom();
+};
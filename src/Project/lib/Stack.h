@@ -0,0 +1,40 @@
+/**
+ *  Stack.h
+ *
+ *  How deep the stack has gone. The free RAM between the heap and the stack
+ *  is painted at startup and the stack overwrites the paint as it grows, so
+ *  the paint left at the bottom is RAM that has never been used: the margin
+ *  the globals leave, as measured on the Uno with drawing and the step
+ *  interrupt on top of each other.
+ *
+ *  Anything allocated after paint() lands in the paint and counts as used.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef STACK_H
+#define STACK_H
+#include <Arduino.h>
+
+// Byte the free RAM is painted with
+#define STACK_PAINT 0xA5
+
+/**
+ * Stack high water mark, all static
+ */
+class Stack {
+public:
+    /**
+     * Paint the RAM between the heap and the stack (call first in setup())
+     */
+    static void paint();
+
+    /**
+     * Bytes of the paint the stack has never reached
+     * @return Bytes
+     */
+    static size_t unused();
+};
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ *  Uart.cpp
+ *
+ *  Interrupt driven USART0, in place of the core's Serial. The receive ring
+ *  holds a whole credit window of frames, bytes lost anyway are counted.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Uart.h"
+
+Uart uart;
+
+/**
+ * Receive complete
+ */
+ISR(USART_RX_vect) {
+    uart.rxIsr();
+}
+
+/**
+ * Data register empty
+ */
+ISR(USART_UDRE_vect) {
+    uart.txIsr();
+}
+
+/**
+ * UBRR0 for a baud (double speed)
+ * @param  baud Baud
+ * @return      UBRR0
+ */
+unsigned long Uart::divider(unsigned long baud) {
+    return (F_CPU / 4 / baud - 1) / 2; // Rounded F_CPU / 8 / baud - 1
+};
+
+/**
+ * The baud can be made within UART_TOLERANCE
+ * @param  baud Baud
+ * @return      true/false
+ */
+bool Uart::supports(unsigned long baud) {
+    if(baud == 0 || baud > F_CPU / 8) return false;
+
+    unsigned long ubrr = divider(baud);
+    if(ubrr > 4095) return false;
+
+    unsigned long real = F_CPU / 8 / (ubrr + 1);
+    unsigned long error = real > baud ? real - baud : baud - real;
+
+    return error * 1000 / baud <= UART_TOLERANCE;
+};
+
+/**
+ * Start, or change the baud once everything written has gone out
+ * @param  baud Baud
+ * @return      false if the baud is not supported (nothing changed)
+ */
+bool Uart::begin(unsigned long baud) {
+    if(!supports(baud)) return false;
+
+    flush();
+
+    noInterrupts();
+    UBRR0 = divider(baud);
+    UCSR0A = _BV(U2X0);
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00); // 8N1
+    UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+    _baud = baud;
+    _sent = false;
+    interrupts();
+
+    return true;
+};
+
+/**
+ * Bytes waiting to be read
+ * @return Bytes
+ */
+int Uart::available() {
+    return (_rxHead - _rxTail) & (UART_RX_SIZE - 1);
+};
+
+/**
+ * Next byte without taking it
+ * @return Byte, -1 if there is none
+ */
+int Uart::peek() {
+    if(_rxHead == _rxTail) return -1;
+    return _rx[_rxTail];
+};
+
+/**
+ * Take the next byte
+ * @return Byte, -1 if there is none
+ */
+int Uart::read() {
+    if(_rxHead == _rxTail) return -1;
+
+    uint8_t data = _rx[_rxTail];
+    _rxTail = (_rxTail + 1) & (UART_RX_SIZE - 1);
+    return data;
+};
+
+/**
+ * Bytes that can be written without waiting
+ * @return Bytes
+ */
+int Uart::availableForWrite() {
+    noInterrupts();
+    uint8_t used = (_txHead - _txTail) & (UART_TX_SIZE - 1);
+    interrupts();
+
+    return UART_TX_SIZE - 1 - used;
+};
+
+/**
+ * Write a byte, waits while the send ring is full
+ * @param  data Byte
+ * @return      1
+ */
+size_t Uart::write(uint8_t data) {
+    uint8_t next = (_txHead + 1) & (UART_TX_SIZE - 1);
+
+    // Full, wait for the interrupt to make room. With interrupts off (called
+    // from an interrupt) send by hand.
+    while(next == _txTail) {
+        if(!(SREG & _BV(SREG_I)) && (UCSR0A & _BV(UDRE0))) txIsr();
+    }
+
+    _tx[_txHead] = data;
+
+    noInterrupts();
+    _txHead = next;
+    _sent = true;
+    UCSR0B |= _BV(UDRIE0);
+    interrupts();
+
+    return 1;
+};
+
+/**
+ * Wait until everything written has gone out
+ */
+void Uart::flush() {
+    if(!_sent) return;
+
+    // Ring emptied, then the last byte shifted out
+    while((UCSR0B & _BV(UDRIE0)) || !(UCSR0A & _BV(TXC0))) {
+        if(!(SREG & _BV(SREG_I)) && (UCSR0A & _BV(UDRE0))) txIsr();
+    }
+};
+
+/**
+ * Bytes lost to a full ring
+ * @return Bytes
+ */
+unsigned long Uart::dropped() {
+    noInterrupts();
+    unsigned long dropped = _dropped;
+    interrupts();
+
+    return dropped;
+};
+
+/**
+ * Times bytes were lost in the USART
+ * @return Times
+ */
+unsigned long Uart::overrun() {
+    noInterrupts();
+    unsigned long overrun = _overrun;
+    interrupts();
+
+    return overrun;
+};
+
+/**
+ * Receive complete interrupt handler, do not call
+ */
+void Uart::rxIsr() {
+
+    // Status first, reading the data clears it
+    uint8_t status = UCSR0A;
+    uint8_t data = UDR0;
+
+    if(status & _BV(DOR0)) _overrun++;
+
+    uint8_t next = (_rxHead + 1) & (UART_RX_SIZE - 1);
+    if(next == _rxTail) {
+        _dropped++;
+        return;
+    }
+
+    _rx[_rxHead] = data;
+    _rxHead = next;
+};
+
+/**
+ * Data register empty interrupt handler, do not call
+ */
+void Uart::txIsr() {
+
+    // Nothing left, stop until the next write
+    if(_txHead == _txTail) {
+        UCSR0B &= ~_BV(UDRIE0);
+        return;
+    }
+
+    UDR0 = _tx[_txTail];
+    _txTail = (_txTail + 1) & (UART_TX_SIZE - 1);
+
+    // Clear the transmit complete flag (by writing it) for flush()
+    UCSR0A = (UCSR0A & _BV(U2X0)) | _BV(TXC0);
+};
@@ -0,0 +1,153 @@
+/**
+ *  Uart.h
+ *
+ *  Interrupt driven USART0, in place of the core's Serial. The receive ring
+ *  holds a whole credit window of frames (see Link.h), so the main loop can
+ *  be busy planning or drawing for as long as it likes without losing bytes,
+ *  at any baud. Bytes that are lost anyway are counted:
+ *
+ *    dropped  the ring was full (the client sent past its credit, or text
+ *             came in faster than it was read)
+ *    overrun  times a byte came in before the last one was taken from the
+ *             USART (an interrupt ran longer than two bytes take)
+ *
+ *  Runs at double speed (U2X0), any baud the 16MHz clock makes within
+ *  UART_TOLERANCE: 9600 up to 1000000, not 230400.
+ *
+ *  Only one of Uart and Serial may be used, they both own the USART
+ *  interrupts (using both fails to link).
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef UART_H
+#define UART_H
+#include <Arduino.h>
+
+// Bytes held waiting to be read (power of 2)
+#define UART_RX_SIZE 128
+
+// Bytes held waiting to be sent (power of 2)
+#define UART_TX_SIZE 32
+
+// Most baud error allowed (per mille)
+#define UART_TOLERANCE 25
+
+// The ring indices are bytes, wrapped with a mask
+static_assert(UART_RX_SIZE <= 256 && (UART_RX_SIZE & (UART_RX_SIZE - 1)) == 0, "Uart: UART_RX_SIZE must be a power of 2, 256 at most");
+static_assert(UART_TX_SIZE <= 256 && (UART_TX_SIZE & (UART_TX_SIZE - 1)) == 0, "Uart: UART_TX_SIZE must be a power of 2, 256 at most");
+
+/**
+ * USART0 with ring buffers both ways
+ */
+class Uart: public Stream {
+private:
+    volatile uint8_t _rx[UART_RX_SIZE];  // Bytes received, not yet read
+    volatile uint8_t _rxHead = 0;        // Where the next byte received goes
+    volatile uint8_t _rxTail = 0;        // Next byte to read
+    volatile uint8_t _tx[UART_TX_SIZE];  // Bytes waiting to be sent
+    volatile uint8_t _txHead = 0;        // Where the next byte written goes
+    volatile uint8_t _txTail = 0;        // Next byte to send
+    volatile unsigned long _dropped = 0; // Bytes lost to a full ring
+    volatile unsigned long _overrun = 0; // Times bytes were lost in the USART
+    unsigned long _baud = 0;             // Current baud, 0 before begin()
+    bool _sent = false;                  // Anything written since begin()
+
+    /**
+     * UBRR0 for a baud (double speed)
+     * @param  baud Baud
+     * @return      UBRR0
+     */
+    static unsigned long divider(unsigned long baud);
+
+public:
+    /**
+     * Uart()
+     */
+    Uart(){};
+
+    /**
+     * The baud can be made within UART_TOLERANCE
+     * @param  baud Baud
+     * @return      true/false
+     */
+    static bool supports(unsigned long baud);
+
+    /**
+     * Start, or change the baud once everything written has gone out
+     * @param  baud Baud
+     * @return      false if the baud is not supported (nothing changed)
+     */
+    bool begin(unsigned long baud);
+
+    /**
+     * Current baud
+     * @return Baud
+     */
+    unsigned long baud(){ return _baud; };
+
+    /**
+     * Bytes waiting to be read
+     * @return Bytes
+     */
+    int available();
+
+    /**
+     * Next byte without taking it
+     * @return Byte, -1 if there is none
+     */
+    int peek();
+
+    /**
+     * Take the next byte
+     * @return Byte, -1 if there is none
+     */
+    int read();
+
+    /**
+     * Bytes that can be written without waiting
+     * @return Bytes
+     */
+    int availableForWrite();
+
+    /**
+     * Write a byte, waits while the send ring is full
+     * @param  data Byte
+     * @return      1
+     */
+    size_t write(uint8_t data);
+    using Print::write;
+
+    /**
+     * Wait until everything written has gone out
+     */
+    void flush();
+
+    /**
+     * Bytes lost to a full ring
+     * @return Bytes
+     */
+    unsigned long dropped();
+
+    /**
+     * Times bytes were lost in the USART
+     * @return Times
+     */
+    unsigned long overrun();
+
+    /**
+     * Receive complete interrupt handler, do not call
+     */
+    void rxIsr();
+
+    /**
+     * Data register empty interrupt handler, do not call
+     */
+    void txIsr();
+};
+
+// The USART
+extern Uart uart;
+
+#endif
@@ -4,16 +4,19 @@
  *  Main controller for drawing to XY-Plotter with Arduino
  *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.2.0
  *  @license MIT (https://mit-license.org)
  */
 
 #include <Arduino.h>
 #include "lib/ShiftedLCD.h"
+#include "lib/Uart.h"
+#include "lib/Stack.h"
 
 #include "Drive.h"
-
-#include <LinkedList.h>
+#include "Pins.h"
+#include "Link.h"
+#include "Parser.h"
 
 #include "stepper/POS.h"
 #include "shapes/Circle.h"
@@ -21,16 +24,29 @@
 #include "shapes/Polygon.h"
 #include "shapes/Bezier.h"
 #include "shapes/Shape.h"
+#include "shapes/ShapeTable.h"
 
 #include "math.h"
 
 class Drive;
 
-//         stp dir en x  x-   x+  buff flip(bool)
-PinMap X = { 4, 2, 3, 0, 340, 510, 50, 1 };
+//                     stp         dir        en            x  x-   x+  buff flip(bool)
+constexpr PinMap X = { X_STEP_PIN, X_DIR_PIN, X_ENABLE_PIN, 0, 340, 510, 50, 1 };
+
+//                     stp         dir        en            y  y-   y+  buff flip(bool)
+constexpr PinMap Y = { Y_STEP_PIN, Y_DIR_PIN, Y_ENABLE_PIN, 1, 340, 510, 50, 0 };
 
-//         stp dir en y  y-   y+  buff flip(bool)
-PinMap Y = { 7, 5, 6, 1, 340, 510, 50, 0 };
+// The steppers write the pins fixed in their template, not the PinMap's
+#ifndef PINMAP_STEPPERS
+static_assert(XStepper::matches(X), "X PinMap pins differ from XStepper's");
+static_assert(YStepper::matches(Y), "Y PinMap pins differ from YStepper's");
+#endif
+
+//             start speed accel (steps/s, steps/s/s)
+Profile XP = { 100,  600,  1000 }; // Drawing (lineTo)
+Profile YP = { 100,  600,  1000 };
+Profile XR = { 100,  1000, 2000 }; // Pen up (moveTo)
+Profile YR = { 100,  1000, 2000 };
 
 // LCD controller
 LiquidCrystal lcd(9);
@@ -45,8 +61,21 @@ const int startButton = 2;
 // Analog input for potentiometer for adjusting pen height
 const int dial = 3;
 
-// List of shapes to draw
-Shape *shapes[50];
+// Shapes to draw, in the order received. Drawing takes them off the front
+// while more are received at the back.
+ShapeTable shapes;
+
+// Binary shape frames from the client, taken into shapes
+Link link(&shapes);
+
+// Text shape commands from the client, added to shapes
+Parser parser(&shapes);
+
+// Baud at power up, the client asks for a faster one in the handshake
+#define START_BAUD 9600
+
+// Longest wait for the rest of a baud request (ms)
+#define BAUD_TIMEOUT 500
 
 /*
     Serial interface control values
@@ -59,80 +88,192 @@ Shape *shapes[50];
     -   Pen
     -   Draw
 
-    Setup. Get a list of shapes from the client.
+    Setup. Get shapes from the client until the shape table is full (or the
+    list is complete).
 
         Shape syntax is in a form structured like:
 
         npC500,500,200,qp...qu
 
         n        : Command recognizing a connection is made
+        b<baud>; : Before n, ask for a faster baud (see handshake())
         p        : Shape data incoming
         C,E,B,P  : Shape type (C=Circle, E=Ellipse, B=Bezier, P=Polygon)
-        0-99999, : integer value, depends on shape as to what it determines (see client code)
+        F,R      : Speed limits instead of a shape (F=drawing, R=pen up), the
+                   values are start speed, speed and acceleration for both axes
+        -123;    : integer value, depends on shape as to what it determines (see client code),
+                   any number of digits (held at the int16 limits)
         q        : Shape data is done
         u        : list of shapes is completed
 
     Pen. Adjust the pen and press start.
 
-    Draw. Draw the series of shapes.
+    Draw. Draw the shapes oldest first, and keep receiving shapes while the
+    moves are stepped out, and while a long shape waits on room in the
+    Drive's queue (its wait hook). Each drawn shape makes room in the table.
+    While the table is full the client is not sent ;next; (back-pressure), so
+    there is no pause between batches.
  */
 // Handshake is completed, and a connection is established
 bool shook = false;
 
+// Receive bytes lost (dropped and overrun) when last reported to the client
+unsigned long lost = 0;
+
 // Used by pen, helps to update LCD of pen low position
 int temp = 0;
 
-// Current index of shape being created or used
-int ind = 0;
+// The shape table is full, add the last shape again once drawing makes room
+bool full = false;
 
 // Flow control values
 bool set = true;   // Get shapes
 bool draw = false; // Draw shapes
 bool pen = false;  // Set pen
 
-// Inchar to parse from client
-char inChar;
+// toggle for completing entire drawing
+bool completedEntireDrawing = false;
+
+/**
+ * Read the digits of a baud request up to its ';'
+ * @return Baud, 0 if the ';' did not come within BAUD_TIMEOUT
+ */
+unsigned long readBaud(){
+    unsigned long baud = 0;
+    unsigned long start = millis();
+
+    while(millis() - start < BAUD_TIMEOUT) {
+        int c = uart.read();
+        if(c == ';') return baud;
+        if(c >= '0' && c <= '9') baud = baud * 10 + (c - '0');
+    }
 
-// List of char to parse from client (numbers 0-99999)
-char data[5];
+    return 0;
+}
 
-// Index control for adding values to data
-int dataInd = 0;
+/**
+ * Establish a connection with the client. The client may first ask for a
+ * faster baud with b<baud>; the reply is ;baud <baud>; (the current baud if
+ * it can not be made), sent at the old baud, then ;Ready; again at the new.
+ */
+void handshake() {
+    while(!shook) {
+        while(uart.available() <= 0) {
+            uart.println(F(";Ready;"));
+            delay(300);
+        }
 
-// Toggle for incoming shape data is ready, used to get shape type to set
-bool incomingShapeDataReady = false;
+        // Anything else is the client connecting
+        if(uart.peek() != 'b') {
+            shook = true;
+            return;
+        }
+        uart.read();
 
-// Shape data is incoming toggle, for numbers
-bool incomingShapeData = false;
+        unsigned long baud = readBaud();
+        if(!Uart::supports(baud)) baud = uart.baud();
 
-// toggle for completing entire drawing
-bool completedEntireDrawing = false;
+        uart.print(F(";baud "));
+        uart.print(baud);
+        uart.println(F(";"));
+        uart.begin(baud); // Waits for the reply to go out first
+    }
+}
 
-// Shape type 1=Cirlce, 2=Ellipse, 3=Bezier, 4=Polygon
-int shapeType = 0;
+/**
+ * Report receive bytes lost to the client
+ */
+void printLost(){
+    lost = uart.dropped() + uart.overrun();
 
-// List of integer values to parse and pass into shapes
-LinkedList<int> *values = new LinkedList<int>();
+    uart.print(F("RX lost: dropped "));
+    uart.print(uart.dropped());
+    uart.print(F(", overrun "));
+    uart.println(uart.overrun());
+}
 
+/**
+ * Report the stack the job left untouched to the client (the RAM margin the
+ * globals leave)
+ */
+void printStack(){
+    uart.print(F("Stack: "));
+    uart.print(Stack::unused());
+    uart.println(F(" bytes never used"));
+}
 
 /**
- * Establish a connection with the client
+ * Report the shape table use to the client
  */
-void handshake() {
-    while(Serial.available() <= 0) {
-        Serial.println(";Ready;");
-        delay(300);
-    }
-    shook = true;
+void printTable(){
+    uart.print(F("Shapes: "));
+    uart.print(shapes.used());
+    uart.print(F("/"));
+    uart.print(SHAPE_TABLE_SIZE);
+    uart.print(F(" bytes, peak "));
+    uart.println(shapes.peak());
 }
 
 /**
- * Clean out all the old values from values to use in another shape
+ * Take in whatever data from the client has come in, binary frames or text
+ * commands, never waiting for more. Shapes go into the shape table, when it
+ * is full the client is not asked for more until drawing has made room.
+ * Call often.
  */
-void cleanValues(){
-    while(values->size() > 0){
-        values->remove(0);
+void receive(){
+
+    // Setup connection if not already made
+    if(!shook) handshake();
+
+    // Let a client out of credit know drawing has made room
+    link.update();
+
+    // Tell the client as soon as receive bytes are lost
+    if(uart.dropped() + uart.overrun() != lost) printLost();
+
+    // Binary frames (see Link.h), a whole frame at a time with no waits
+    if(link.busy() || uart.peek() == LINK_START) {
+        link.read();
+
+        // Take in the shapes of a whole frame, the client only sends more
+        // than fit if it went over its credit, then it waits for the ack
+        bool room = link.take();
+        if(!room && !full) uart.println(F(";wait;")); // Send wait command
+        full = !room;
+        if(link.end()) completedEntireDrawing = true;
+
+        // Table full (or too full for the client to send another frame) or
+        // the list is complete, set up the pen and start drawing
+        if(set && (full || completedEntireDrawing || shapes.room() < LINK_COST)) {
+            set = false;
+            pen = true;
+        }
+        return;
     }
+
+    // Text commands (see Parser.h), a byte at a time with no waits
+    parser.read();
+
+    // Add the shape that is in. The client is not sent ;next; while the
+    // table is full, the shape is added once drawing has made room.
+    bool room = parser.take();
+    if(!room && !full) uart.println(F(";wait;")); // Send wait command
+    full = !room;
+    if(parser.end()) completedEntireDrawing = true;
+
+    // Table full or the list is complete, set up the pen and start drawing
+    if(set && (full || completedEntireDrawing)) {
+        set = false;
+        pen = true;
+
+        if(completedEntireDrawing) {
+            uart.println(F("List: "));
+            shapes.print();
+        }
+    }
+
+    // Shown by drive->run(), not per character
+    if(set) drive->status()->setMode(parser.busy() ? F("Receiving") : F("Waiting"));
 }
 
 /**
@@ -140,19 +281,28 @@ void cleanValues(){
  */
 void setup() {
 
+    // Paint the free RAM before anything uses the stack deeply
+    Stack::paint();
+
     // Setup LCD screen
     lcd_pointer->begin(16, 2);
     lcd_pointer->noCursor();
 
     // Print a startup to LCD
     lcd_pointer->clear();
-    lcd_pointer->print("Starting XY");
+    lcd_pointer->print(F("Starting XY"));
 
-    // Start Serial
-    Serial.begin(9600);
+    // Start the Uart
+    uart.begin(START_BAUD);
 
     // Setup drive (servo, pins, steppers, etc.)
     drive->attach();
+    Shape::attach(drive, lcd_pointer);
+    drive->setProfile(XP, YP);
+    drive->setRapid(XR, YR);
+
+    // Keep taking in shapes while a long one waits on room in the queue
+    drive->setWait(receive);
 }
 
 /**
@@ -170,278 +320,18 @@ void loop() {
     */
     // =========================================================================
     /**
-     * Setup the shapes to be drawn. Connect to client and get a list of shapes
-     * to draw.
+     * Setup the shapes to be drawn. Connect to client and fill the shape
+     * table, the rest are received while drawing.
      */
     while(set){
 
-        // Serial.println(free_ram());
-
-        // Setup connection if not already made
-        if(!shook) handshake();
+        // uart.println(free_ram());
 
-        // Data exists to be read
-        if(Serial.available() > 0) {
+        // Keep the Drive serviced
+        drive->run();
 
-            // We have incoming shape data
-            if(incomingShapeData) {
-
-                // Parse single character
-                char v = (char)Serial.read();
-
-                // End of number data
-                if(v == ';') {
-                    dataInd = 0; // Reset data index
-                    // Serial.available() > 0 will end here and the data will be
-                    // parsed in Serial.available() <= 0
-
-                // End of shape data
-                } else if(v == 'q'){
-                    inChar = 'q';              // Toggle check for next section
-                    incomingShapeData = false; // Toogle end of shape data
-
-                // Add new data to (char)data array
-                } else {
-                    data[dataInd] = v; // Assign char
-                    dataInd++;         // Increment index
-
-                }
-
-                // TODO: Clean LCD info
-                lcd_pointer->clear();
-                lcd_pointer->setCursor(0, 1);
-                lcd_pointer->print("incomingShapeData");
-                lcd_pointer->setCursor(0, 0);
-
-                int val = 0;
-
-                for(int i=0; i<5; i++){
-                    if(data[i] != NULL){
-                        val = (val*10) + (data[i] - '0');
-                    }
-                }
-                lcd_pointer->print(val);
-                lcd_pointer->print("      ");
-                delay(50);
-            // Command for what to do next data
-            } else {
-                inChar = (char)Serial.read(); // Read data command
-
-                // TODO: clean/remove LCD info
-                lcd_pointer->clear();
-                lcd_pointer->print(inChar);
-                delay(50);
-
-            }
-        }
-
-        // Input from client is empty, parse chunk of data
-        if(Serial.available() <= 0){
-
-            // Connection was established, client sent 'n' confirmation
-            if(inChar == 'n') {
-                Serial.println(";next;"); // Ask for next chunk
-
-            // Shape data is going to be sent next, prep for shape dat
-            } else if(inChar == 'p') {
-                incomingShapeDataReady = true; // Shape data will be coming
-                Serial.println(";next;");      // Ask for next chunk
-
-            // End of shape data, parse values into a shape
-            } else if(inChar == 'q') {
-                incomingShapeData = false; // Reset flag for incoming shape data
-
-                // TODO: Remove Serial info (used for debugging and testing)
-                // for(int i=0; i<values->size(); i++){
-                //     Serial.print(values->get(i));
-                //     Serial.print(",");
-                // }
-
-                // Parse data for a Circle
-                if(shapeType == 1) {
-                    int cx = values->get(0); // Get centre x
-                    int cy = values->get(1); // Get centre y
-                    int r = values->get(2);  // Get radius
-
-                    // Assign circle to list
-                    shapes[ind] = new Circle(cx, cy, r, drive, lcd_pointer);
-
-                    ind++;         // Increment assignment index
-                    cleanValues(); // Clean out values list
-
-                    shapeType = 0;
-
-                // Parse data for an Ellipse
-                } else if(shapeType == 2) {
-
-                    // Parse data for an Ellipse with rotation applied
-                    Serial.println(values->size());
-                    if(values->size() > 4) {
-                        int cx = values->get(0); // Get centre x
-                        int cy = values->get(1); // Get centre y
-                        int a = values->get(2);  // Get a length
-                        int b = values->get(3);  // Get b length
-
-                        //        Get origin.x   Get origin.y
-                        POS o = {values->get(4), values->get(5)};
-                        double ang = values->get(6)*PI/180; // Get angle
-                        // Values should be sent as degrees in integer form and
-                        // will be converted to a double in radians. This
-                        // simplifies the conversion as a decimal value would be
-                        // far more difficult to convert. (This may yet change)
-
-                        // Assign ellipse to list
-                        shapes[ind] = new Ellipse(cx, cy, a, b, o, ang, drive, lcd_pointer);
-
-                        ind++;         // Increment assignment index
-                        cleanValues(); // Clean out values list
-
-                        shapeType = 0;
-
-                    } else {
-                        int cx = values->get(0); // Get centre x
-                        int cy = values->get(1); // Get centre y
-                        int a = values->get(2);  // Get a length
-                        int b = values->get(3);  // Get b length
-
-                        // Assign ellipse to list
-                        shapes[ind] = new Ellipse(cx, cy, a, b, drive, lcd_pointer);
-
-                        ind++;         // Increment assignment index
-                        cleanValues(); // Clean out values list
-
-                        shapeType = 0;
-                    }
-
-                // Parse data for a Bezier curve
-                } else if(shapeType == 3) {
-
-                    // Get start point
-                    //             p0.x           p0.y
-                    POS p0 = {values->get(0), values->get(1)};
-
-                    // Get first control point
-                    //             p1.x           p1.y
-                    POS p1 = {values->get(2), values->get(3)};
-
-                    // Get second control point
-                    //             p2.x           p2.y
-                    POS p2 = {values->get(4), values->get(5)};
-
-                    // Get end point
-                    //             p3.x           p3.y
-                    POS p3 = {values->get(6), values->get(7)};
-
-                    // Assign bezier curve to list
-                    shapes[ind] = new Bezier(p0, p1, p2, p3, drive, lcd_pointer);
-
-                    ind++;         // Increment assignment index
-                    cleanValues(); // Clean out values list
-
-                    shapeType = 0;
-
-                // Parse data for a Polygon
-                } else if(shapeType == 4) {
-                    // Create a new list for points
-                    LinkedList<POS> *points = new LinkedList<POS>();
-
-                    // Assign values to POS points in the points list
-                    for(int i=0; i<values->size(); i+=2){
-                        points->add({values->get(i), values->get(i+1)});
-                    }
-
-                    // Assign polygon to list
-                    shapes[ind] = new Polygon(points, drive, lcd_pointer);
-
-                    ind++;         // Increment assignment index
-                    cleanValues(); // Clean out values list
-
-                }
-
-                // We hit our max array size, draw the first 50 shapes and ask
-                // for more latter
-                if(ind == 49) {
-                    Serial.println(";wait;"); // Send wait command
-                    set = false;              // stop asking for shapes
-                    pen = true;               // Go to pen setup
-                    ind = 0;                  // reset index for adding new shapes later
-
-                } else {
-                    Serial.println(";next;"); // Ask for next chunk
-
-                }
-
-            // End of shapes data, go to next step
-            } else if(inChar == 'u') {
-                set = false;                   // Toggle done getting shapes
-                pen = true;                    // Toggle setup pen
-                completedEntireDrawing = true; // Toggle so arduino does not ask
-                                               // for more shapes later
-
-                for(int i=0; i<50; i++){
-                    if(shapes[i] != NULL){
-                        Serial.print("List: ");
-                        shapes[i]->print();
-                    }
-                    delay(50);
-                }
-
-            // Deal with other data characters
-            } else {
-
-                // Get ready for incoming shape data
-                if(incomingShapeDataReady) {
-
-                    // Set toggle for getting data
-                    incomingShapeData = true;
-
-                    // Set toggle for setup-for-shape-data
-                    incomingShapeDataReady = false;
-
-                    // Assign type of data to receive
-                    if(inChar == 'C') shapeType = 1;
-                    if(inChar == 'E') shapeType = 2;
-                    if(inChar == 'B') shapeType = 3;
-                    if(inChar == 'P') shapeType = 4;
-
-                    // TODO: cleanup lcd info
-                    lcd_pointer->print(shapeType);
-                    Serial.println(";next;"); // Ask for next chunk
-
-                // Parse incoming shape data, positional integers
-                } else if(incomingShapeData) {
-
-                    // Set initial integer
-                    int val = 0;
-
-                    // Loop through char data array
-                    for(int i=0; i<5; i++){
-                        if(data[i] != NULL){ // if index is not empty, add to val
-
-                            // Multiply val by 10 and add single digit integer
-                            // Parse data[i] char to proper integer
-                            val = (val*10) + (data[i] - '0');
-
-                            // EG: data = ['5', '0', '0'];
-                            //
-                            // val = 0 + 5 - '0'; (- '0' fixes int casting of char )
-                            // val = 5*10 + 0 - '0'
-                            // val = 50*10 + 0 -'0'
-                            // val = 500
-                        }
-                    }
-                    for(int i=0; i<5; i++){
-                        data[i] = NULL;
-                    }
-
-                    // Add value to list
-                    values->add(val);
-                    Serial.println(";next;"); // Ask for next chunk
-
-                }
-            }
-        }
-        delay(50);
+        // Take in shapes until the table is full
+        receive();
 
     }
 
@@ -457,27 +347,33 @@ void loop() {
     while(pen){
 
         // Get pen lowering point, pot resistance 0-1023 to servo angle 0-71 degrees
-        temp = drive->setPen(map(analogRead(dial), 0, 1023, 0, 71));
+        temp = drive->setPen(map(AnalogButtons::sample(dial), 0, 1023, 0, 71));
 
         // Inform the user through LCD
         lcd_pointer->clear();
-        lcd_pointer->print("Pen: ");
+        lcd_pointer->print(F("Pen: "));
 
         // Maps low point from inverted angle to percent 0 at lowest, 100 at highest
         lcd_pointer->print(map(temp, 0, 71, 100, 0));
 
         // Inform client as well
-        Serial.print("Pen: ");
-        Serial.println(map(temp, 0, 71, 100, 0));
+        uart.print(F("Pen: "));
+        uart.println(map(temp, 0, 71, 100, 0));
         delay(300);
 
         // Start button pressed
-        if(analogRead(startButton) > 1000) {
+        if(AnalogButtons::sample(startButton) > 1000) {
             pen = false; // Toggle pen setup
             draw = true; // Toggle draw section
-            Serial.println("Start drawing");
+            uart.println(F("Start drawing"));
             lcd_pointer->clear();
-            lcd_pointer->print("Start drawing");
+
+            // Status takes the LCD back (shapes show themselves on the
+            // second line), count the writes for this job
+            drive->status()->invalidate();
+            drive->status()->setMode(F("Drawing"));
+            drive->status()->flush();
+            drive->status()->reset();
             delay(300);
 
         }
@@ -495,32 +391,30 @@ void loop() {
     //==========================================================================
     while(draw){
 
-        // Loop through shapes and draw the shapes
-        //
-        // BUG: In between each shape plotter wants to reset to (0,0)
-        for(int i=0; i<50; i++){
-            if(shapes[i] != NULL) {
-                shapes[i]->draw(true);
-            }
-        }
+        // Draw the oldest shape, its moves queue up behind the ones being
+        // drawn. Nothing to draw, keep the Drive serviced.
+        if(!shapes.draw(true)) drive->run();
 
-        // Done drawing
-        draw = false;
+        // Take in more shapes as drawing makes room for them
+        receive();
 
         // We completed Entire Drawing stop doing thing
-        if(completedEntireDrawing) {
+        if(completedEntireDrawing && shapes.count() == 0 && !full) {
+            draw = false;
+            printTable();
+
             drive->moveTo(0,0); // Return to (0,0)
+            drive->sync();      // Wait for the queued moves to be drawn
 
             // Inform client/user that we are done
-            Serial.println("Done!");
-            lcd_pointer->clear();
-            lcd_pointer->print("Done!");
-
-        // Get set setup so we can get more shapes!
-        } else {
-            set = true;
+            uart.println(F("Done!"));
+            drive->status()->setMode(F("Done!"));
+            drive->status()->flush();
+
+            uart.print(F("LCD writes: "));
+            uart.println(drive->status()->writes());
+            printLost();
+            printStack();
         }
-
-        delay(300);
     }
 }
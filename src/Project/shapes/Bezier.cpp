@@ -4,13 +4,15 @@
  *  Draws a bezier curve between two points p0 and p3, with control points
  *  p1 and p2.
  *
+ *  The curve is split in half (de Casteljau) until each piece is within the
+ *  chord tolerance of a line, then drawn as those lines.
+ *
  *  @author Drew Sommer
- *  @version 1.0.2
+ *  @version 1.3.1
  *  @license MIT (https://mit-license.org)
  */
-// TODO: Test Bezier curve
 #include "Bezier.h"
-#include "math.h"
+#include "../lib/Fixed.h"
 
 /**
  * Bezier curve
@@ -18,16 +20,66 @@
  * @param p1    First control point
  * @param p2    Second control point
  * @param p3    End point
- * @param drive Drive controller
- * @param lcd   LCD screen controller
  */
-Bezier::Bezier(POS p0, POS p1, POS p2, POS p3, Drive *drive, LiquidCrystal *lcd):
-    Shape(drive, lcd),
+Bezier::Bezier(POS p0, POS p1, POS p2, POS p3):
+    Shape(),
     _p0(p0),
     _p1(p1),
     _p2(p2),
     _p3(p3){};
 
+/**
+ * The curve is within the tolerance of the line between its ends. Bounds the
+ * distance by how far the control points pull off the line, no sqrt
+ *   u = 3p1 - 2p0 - p3,  v = 3p2 - p0 - 2p3
+ *   max(ux^2, vx^2) + max(uy^2, vy^2) <= 16 tolerance^2
+ * @param  c Curve
+ * @return   true/false
+ */
+bool Bezier::flat(Curve *c) {
+    unsigned long ux = labs(3 * c->x[1] - 2 * c->x[0] - c->x[3]);
+    unsigned long uy = labs(3 * c->y[1] - 2 * c->y[0] - c->y[3]);
+    unsigned long vx = labs(3 * c->x[2] - c->x[0] - 2 * c->x[3]);
+    unsigned long vy = labs(3 * c->y[2] - c->y[0] - 2 * c->y[3]);
+    unsigned long mx = max(ux, vx);
+    unsigned long my = max(uy, vy);
+
+    // 4 tolerance in 1/BEZIER_ONE steps, kept small enough to square
+    unsigned long limit = Fixed::scale(4 * BEZIER_ONE, Fixed::fromRaw(SHAPE_TOLERANCE));
+    if(limit > 32767) limit = 32767;
+
+    if(mx > limit || my > limit) return false;
+
+    return mx * mx + my * my <= limit * limit;
+};
+
+/**
+ * Split a curve in half at t = 1/2 (de Casteljau)
+ * @param c     Curve, replaced by its first half
+ * @param right Set to the second half
+ */
+void Bezier::split(Curve *c, Half *right) {
+    long *p[2] = { c->x, c->y };
+    long *r[2] = { right->x, right->y };
+
+    for(uint8_t i = 0; i < 2; i++) {
+        long p01 = (p[i][0] + p[i][1]) / 2;
+        long p12 = (p[i][1] + p[i][2]) / 2;
+        long p23 = (p[i][2] + p[i][3]) / 2;
+        long p012 = (p01 + p12) / 2;
+        long p123 = (p12 + p23) / 2;
+        long mid = (p012 + p123) / 2;
+
+        r[i][0] = p123;
+        r[i][1] = p23;
+        r[i][2] = p[i][3];
+
+        p[i][1] = p01;
+        p[i][2] = p012;
+        p[i][3] = mid;
+    }
+};
+
 /**
  * Draw the Bezier curve
  * @param  p Whether or not to print details
@@ -46,34 +98,48 @@ POS Bezier::draw(bool p) {
     // Move to start point
     _drive->moveTo(_p0.x, _p0.y);
 
-    int resolution = 0;
-    resolution += abs(_p1.x - _p0.x);
-    resolution += abs(_p2.x - _p1.x);
-    resolution += abs(_p3.x - _p2.x);
-
-    for(int i=0; i<=resolution; i++){
-        double t = (double)i/(double)resolution;  // 0 <= t <= 1
-        double t2 = pow(t, 2);    // t^2
-        double t3 = pow(t, 3);    // t^3
-
-        // Get our x value
-        int x = (int)(
-            _p0.x +
-            3 * t * (_p1.x - _p0.x) +
-            3 * t2 * (_p0.x + _p2.x - 2 * _p1.x) +
-            t3 * (_p3.x - _p0.x + 3 * _p1.x - 3 * _p2.x)
-        );
-
-        // Get our y value
-        int y = (int)(
-            _p0.y +
-            3 * t * (_p1.y - _p0.y) +
-            3 * t2 * (_p0.y + _p2.y - 2 * _p1.y) +
-            t3 * (_p3.y - _p0.y + 3 * _p1.y - 3 * _p2.y)
-        );
-
-        // Draw to our next value
-        _drive->lineTo(x, y);
+    Curve c = {
+        { _p0.x * BEZIER_ONE, _p1.x * BEZIER_ONE, _p2.x * BEZIER_ONE, _p3.x * BEZIER_ONE },
+        { _p0.y * BEZIER_ONE, _p1.y * BEZIER_ONE, _p2.y * BEZIER_ONE, _p3.y * BEZIER_ONE }
+    };
+
+    // Second halves waiting to be drawn, at most one per level
+    Half stack[BEZIER_DEPTH];
+    uint8_t top = 0;
+    uint8_t depth = 0;
+
+    POS last = _p0;
+
+    for(;;) {
+
+        // Too far from a line, draw the first half and keep the second
+        if(depth < BEZIER_DEPTH && !flat(&c)) {
+            split(&c, &stack[top]);
+            stack[top++].depth = ++depth;
+            continue;
+        }
+
+        // Draw to the end of the piece, unless it rounds to where we are
+        POS end = {
+            (int)((c.x[3] + BEZIER_ONE / 2) >> BEZIER_SHIFT),
+            (int)((c.y[3] + BEZIER_ONE / 2) >> BEZIER_SHIFT)
+        };
+        if(end.x != last.x || end.y != last.y) {
+            _drive->lineTo(end.x, end.y);
+            last = end;
+        }
+
+        if(top == 0) break;
+
+        // Carry on with the latest second half
+        Half *h = &stack[--top];
+        c.x[0] = c.x[3];
+        c.y[0] = c.y[3];
+        for(uint8_t i = 0; i < 3; i++) {
+            c.x[i + 1] = h->x[i];
+            c.y[i + 1] = h->y[i];
+        }
+        depth = h->depth;
     }
 
     // Return updated position
@@ -85,40 +151,40 @@ POS Bezier::draw(bool p) {
  */
 void Bezier::print() {
 
-    Serial.print("B({");
-    Serial.print(_p0.x);
-    Serial.print(",");
-    Serial.print(_p0.y);
-    Serial.print("},{");
-    Serial.print(_p1.x);
-    Serial.print(",");
-    Serial.print(_p1.y);
-    Serial.print("},{");
-    Serial.print(_p2.x);
-    Serial.print(",");
-    Serial.print(_p2.y);
-    Serial.print("},{");
-    Serial.print(_p3.x);
-    Serial.print(",");
-    Serial.print(_p3.y);
-    Serial.println("})");
+    uart.print(F("B({"));
+    uart.print(_p0.x);
+    uart.print(F(","));
+    uart.print(_p0.y);
+    uart.print(F("},{"));
+    uart.print(_p1.x);
+    uart.print(F(","));
+    uart.print(_p1.y);
+    uart.print(F("},{"));
+    uart.print(_p2.x);
+    uart.print(F(","));
+    uart.print(_p2.y);
+    uart.print(F("},{"));
+    uart.print(_p3.x);
+    uart.print(F(","));
+    uart.print(_p3.y);
+    uart.println(F("})"));
 
     _lcd->setCursor(0, 1);
-    _lcd->print("B({");
+    _lcd->print(F("B({"));
     _lcd->print(_p0.x);
-    _lcd->print(",");
+    _lcd->print(F(","));
     _lcd->print(_p0.y);
-    _lcd->print("},{");
+    _lcd->print(F("},{"));
     _lcd->print(_p1.x);
-    _lcd->print(",");
+    _lcd->print(F(","));
     _lcd->print(_p1.y);
-    _lcd->print("},{");
+    _lcd->print(F("},{"));
     _lcd->print(_p2.x);
-    _lcd->print(",");
+    _lcd->print(F(","));
     _lcd->print(_p2.y);
-    _lcd->print("},{");
+    _lcd->print(F("},{"));
     _lcd->print(_p3.x);
-    _lcd->print(",");
+    _lcd->print(F(","));
     _lcd->print(_p3.y);
-    _lcd->print("})");
+    _lcd->print(F("})"));
 };
@@ -4,14 +4,26 @@
  *  Draws a bezier curve between two points p0 and p3, with control points
  *  p1 and p2.
  *
+ *  The curve is split in half (de Casteljau) until each piece is within the
+ *  chord tolerance of a line, then drawn as those lines.
+ *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.3.0
  *  @license MIT (https://mit-license.org)
  */
 #ifndef BEZIER_H
 #define BEZIER_H
 #include "./Shape.h"
 #include "../stepper/POS.h"
+#include <stdint.h>
+
+// Deepest the curve is split, 2^BEZIER_DEPTH lines at most. Each level keeps
+// one half waiting on a stack in draw().
+#define BEZIER_DEPTH 8
+
+// Control points are kept in 1/BEZIER_ONE steps while splitting
+#define BEZIER_SHIFT 8
+#define BEZIER_ONE (1L << BEZIER_SHIFT)
 
 class Bezier: public Shape {
 private:
@@ -20,6 +32,38 @@ private:
     POS _p2; // second control point
     POS _p3; // end point
 
+    /**
+     * Control points of (part of) the curve, in 1/BEZIER_ONE steps
+     */
+    struct Curve {
+        long x[4]; // x of p0 to p3
+        long y[4]; // y of p0 to p3
+    };
+
+    /**
+     * Second half of a split curve, waiting its turn. It starts where the
+     * first half ends.
+     */
+    struct Half {
+        long x[3];     // x of p1 to p3
+        long y[3];     // y of p1 to p3
+        uint8_t depth; // Times split
+    };
+
+    /**
+     * The curve is within the tolerance of the line between its ends
+     * @param  c Curve
+     * @return   true/false
+     */
+    bool flat(Curve *c);
+
+    /**
+     * Split a curve in half at t = 1/2 (de Casteljau)
+     * @param c     Curve, replaced by its first half
+     * @param right Set to the second half
+     */
+    void split(Curve *c, Half *right);
+
 public:
 
     /**
@@ -33,10 +77,8 @@ public:
      * @param p1    First control point
      * @param p2    Second control point
      * @param p3    End point
-     * @param drive Drive controller
-     * @param lcd   LCD screen controller
      */
-    Bezier(POS p0, POS p1, POS p2, POS p3, Drive *drive, LiquidCrystal *lcd); // primary constructor
+    Bezier(POS p0, POS p1, POS p2, POS p3); // primary constructor
 
     /**
      * Draw the Bezier curve
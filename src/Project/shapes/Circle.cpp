@@ -2,10 +2,10 @@
 *  Circle.cpp
 *
 *  Draws a circle. Subclass of Ellipse since the formula for a circle is the
-*  formula for an ellipse with a=b.
+*  formula for an ellipse with a=b. The radius is kept as a.
 *
 *  @author Drew Sommer
-*  @version 1.0.1
+*  @version 1.1.1
 *  @license MIT (https://mit-license.org)
 */
 #include "Circle.h"
@@ -16,14 +16,9 @@
  * @param cx    Centre x
  * @param cy    Centre y
  * @param r     Radius
- * @param drive Drive controller
- * @param lcd   LCD screen controller
  */
-Circle::Circle(int cx, int cy, int r, Drive *drive, LiquidCrystal *lcd):
-    Ellipse(cx, cy, r, r, drive, lcd),
-    _cx(cx),
-    _cy(cy),
-    _r(r){}
+Circle::Circle(int cx, int cy, int r):
+    Ellipse(cx, cy, r, r){}
 
 /**
  * Draw the Circle
@@ -43,21 +38,21 @@ POS Circle::draw(bool p=false) {
  * Print details to LCD and Serial
  */
 void Circle::print() {
-    Serial.print("C(");
-    Serial.print(_cx);
-    Serial.print(",");
-    Serial.print(_cy);
-    Serial.print(",");
-    Serial.print(_r);
-    Serial.println(")");
+    uart.print(F("C("));
+    uart.print(_cx);
+    uart.print(F(","));
+    uart.print(_cy);
+    uart.print(F(","));
+    uart.print(_a);
+    uart.println(F(")"));
 
     _lcd->setCursor(0,1);
-    _lcd->print("C(");
+    _lcd->print(F("C("));
     _lcd->print(_cx);
-    _lcd->print(",");
+    _lcd->print(F(","));
     _lcd->print(_cy);
-    _lcd->print(",");
-    _lcd->print(_r);
-    _lcd->print(")");
+    _lcd->print(F(","));
+    _lcd->print(_a);
+    _lcd->print(F(")"));
 
 };
@@ -2,10 +2,10 @@
  *  Circle.h
  *
  *  Draws a circle. Subclass of Ellipse since the formula for a circle is the
- *  formula for an ellipse with a=b.
+ *  formula for an ellipse with a=b. The radius is kept as a.
  *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.1.0
  *  @license MIT (https://mit-license.org)
  */
 #ifndef CIRCLE_H
@@ -17,11 +17,6 @@
  * Draw a circle
  */
 class Circle: public Ellipse {
-private:
-    int _cx; // centre x
-    int _cy; // centre y
-    int _r;  // radius
-
 public:
 
     /**
@@ -34,10 +29,8 @@ public:
      * @param cx    Centre x
      * @param cy    Centre y
      * @param r     Radius
-     * @param drive Drive controller
-     * @param lcd   LCD screen controller
      */
-    Circle(int cx, int cy, int r, Drive *drive, LiquidCrystal *lcd); // primary constructor
+    Circle(int cx, int cy, int r); // primary constructor
 
     /**
      * Draw the Circle
@@ -3,12 +3,15 @@
  *
  *  Used to draw an ellipse. Supports rotation.
  *
+ *  Without a rotation the steppers trace the ellipse a quarter at a time
+ *  (Drive::arcTo), a step at a time. Rotated ellipses are drawn as lines
+ *  through points of the curve, as few as the chord tolerance allows.
+ *
  *  @author Drew Sommer
- *  @version 1.0.3
+ *  @version 1.2.1
  *  @license MIT (https://mit-license.org)
  */
 #include "Ellipse.h"
-#include "math.h"
 
 /**
  * Create an Ellipse without a rotation
@@ -16,11 +19,9 @@
  * @param cy    Centre y position
  * @param a     width
  * @param b     height
- * @param drive Drive controller
- * @param lcd   LCD screen controller
  */
-Ellipse::Ellipse(int cx, int cy, int a, int b, Drive *drive, LiquidCrystal *lcd):
-    Shape(drive, lcd),
+Ellipse::Ellipse(int cx, int cy, int a, int b):
+    Shape(),
     _cx(cx),
     _cy(cy),
     _a(a),
@@ -37,16 +38,10 @@ Ellipse::Ellipse(int cx, int cy, int a, int b, Drive *drive, LiquidCrystal *lcd)
      * @param a      width
      * @param b      height
      * @param origin (x,y) to rotate by
-     * @param angle  angle of rotation (radians)
-     * @param drive  Drive controller
-     * @param lcd    LCD screen controller
+     * @param angle  angle of rotation (degrees)
      */
-Ellipse::Ellipse(
-    int cx, int cy, int a, int b,
-    POS origin, double angle, Drive *drive,
-    LiquidCrystal *lcd
-):
-    Shape(drive, lcd),
+Ellipse::Ellipse(int cx, int cy, int a, int b, POS origin, int angle):
+    Shape(),
     _cx(cx),
     _cy(cy),
     _a(a),
@@ -61,118 +56,111 @@ Ellipse::Ellipse(
  *
  * Latex:
  $$
- y = \pm\frac{b}{a}\sqrt{a^2 - x^2} \\
- (x + cx, y+ cy)
+ \left[
+ \begin{array}{c}
+ x \\ y
+ \end{array}
+ \right]
+ =
+ \left[
+ \begin{array}{cc}
+ \cos\theta & -\sin\theta \\
+ \sin\theta & \cos\theta
+ \end{array}
+ \right]
+ \left[
+ \begin{array}{c}
+ a\cos t \\ b\sin t
+ \end{array}
+ \right]
+ +
+ \left[
+ \begin{array}{c}
+ cx \\ cy
+ \end{array}
+ \right]
  $$
  */
 POS Ellipse::draw(bool p) {
 
     if(p) print();
 
-    // moveTo start point
-    if(_angle != 0) { // If rotation neede
-        POS xy = rotate(_cx - _a, _cy);
-        _drive->moveTo(xy.x, xy.y);
-
-    } else { // Do not rotate
+    // Without a rotation the steppers trace the ellipse a quarter at a time,
+    // step by step (midpoint), from the left tip round through the top
+    if(_angle == 0) {
         _drive->moveTo(_cx - _a, _cy);
-    }
+        _drive->arcTo(_cx, _cy + _b, false);
+        _drive->arcTo(_cx + _a, _cy, true);
+        _drive->arcTo(_cx, _cy - _b, false);
+        _drive->arcTo(_cx - _a, _cy, true);
 
-    // Draw the upper 1/2 of the ellipse
-    for(int x=-_a; x<=_a; x++){
-
-        // Get our y
-        /*
-        $$
-        y = \frac{b}{a}\sqrt{a^2 - x^2} \\
-        (x + cx, y+ cy)
-        $$
-         */
-        int y = (int)(((double)_b/(double)_a)*sqrt(pow(_a, 2) - pow(x, 2)));
-
-        if(_angle != 0) { // If rotation wanted
-            POS xy = rotate(x, y);
-            _drive->lineTo(xy.x+_cx, xy.y+_cy);
-
-        } else { // Do not rotate
-            _drive->lineTo(x+_cx, y+_cy);
-        }
+        return _drive->get();
     }
 
-    // Draw the lower 1/2 of the ellipse
-    for(int x=_a; x>=-_a; x--){
-
-        // Get our y
-        /*
-        $$
-        y = -\frac{b}{a}\sqrt{a^2 - x^2} \\
-        (x + cx, y+ cy)
-        $$
-         */
-        int y = (int)(((double)_b/(double)_a)*sqrt(pow(_a, 2) - pow(x, 2)));
-
-        if(_angle != 0) { // If rotation wanted
-            POS xy = rotate(x, -y);
-            _drive->lineTo(xy.x+_cx, xy.y+_cy);
-
-        } else { // Do not rotate
-            _drive->lineTo(x+_cx, -y+_cy);
-        }
+    // Rotated, draw lines through points spaced evenly in t. A line strays
+    // at most max(a, b) dt^2 / 8 from the curve, so for the tolerance
+    //   dt = sqrt(8 tolerance / max(a, b))
+    // The axes are sent as they are, either may be negative or 0.
+    long r = max(labs(_a), labs(_b));
+    Fixed step = FIXED_TWO_PI / Fixed(ELLIPSE_LINES);
+    if(r > 0) {
+        Fixed fit = Fixed::sqrt(Fixed::fromRaw(SHAPE_TOLERANCE) * Fixed(8) / Fixed((int)min(r, 32767L)));
+        if(fit > step) step = fit;
     }
+    int n = (FIXED_TWO_PI / step).floor() + 1;
+    if(n < 8) n = 8;
+    Fixed dt = FIXED_TWO_PI / Fixed(n);
 
-    // Updated position
-    return _drive->get();
-};
-
-/**
- * Rotate the ellipse by the origin point, point by point
- * @param  x int x point
- * @param  y int y point
- * @return   new position
- *
- Latex:
-$$
-\left[
-\begin{array}{cc}
-\cos\theta & -\sin\theta \\
-\sin\theta & \cos\theta
-\end{array}
-\right]
-\left[
-\begin{array}{c}
-x \\ y
-\end{array}
-\right]
-$$
- */
-POS Ellipse::rotate(int x, int y){
-
-    // Our shift point
-    POS shift = {_origin.x - _cx, _origin.y - _cy};
-
-    // The new position
-    POS newShift = {0, 0};
-
-    // If we have not already calculated our cos and sin, do so and save
-    if(!_rotatedValues) {
-        _rotatedValues = true;
-        _cosA = cos(_angle);
-        _sinA = sin(_angle);
-    }
+    // Rotation, worked out once for the shape
+    Fixed angle = Fixed::fromDegrees(_angle);
+    Fixed cosA = Fixed::cos(angle);
+    Fixed sinA = Fixed::sin(angle);
 
     // Since rotation is done by the centre of the Ellipse we rotate the
     // shift point to know where to move the Ellipse before re-centering
     // the Ellipse. Only really used when the origin is not the centre of
     // the Ellipse.
-    newShift.x = (int)(_cosA*shift.x - _sinA*shift.y);
-    newShift.y = (int)(_sinA*shift.x + _cosA*shift.y);
+    int shiftX = _origin.x - _cx;
+    int shiftY = _origin.y - _cy;
+    int cx = _cx - (cosA*shiftX - sinA*shiftY).toInt();
+    int cy = _cy - (sinA*shiftX + cosA*shiftY).toInt();
+
+    // Rotated axes, a point is the centre + A cos t + B sin t
+    Fixed ax = cosA * _a;
+    Fixed ay = sinA * _a;
+    Fixed bx = -(sinA * _b);
+    Fixed by = cosA * _b;
+
+    // Start from the left tip (t = pi) and go round through the top, turning
+    // (cos t, sin t) back by dt each point instead of calling cos and sin
+    Fixed c = Fixed(-1);
+    Fixed s = Fixed();
+    Fixed cosD = Fixed::cos(dt);
+    Fixed sinD = Fixed::sin(dt);
+    Fixed half = Fixed::fromRaw(FIXED_ONE / 2);
+
+    POS start = { cx + (ax*c + bx*s).toInt(), cy + (ay*c + by*s).toInt() };
+    _drive->moveTo(start.x, start.y);
+
+    for(int i = 1; i < n; i++) {
+        Fixed next = c*cosD + s*sinD;
+        s = s*cosD - c*sinD;
+        c = next;
+
+        // Rounding lets the length drift, pull it back onto the unit circle
+        //   1 / sqrt(l) ~ (3 - l) / 2 near l = 1
+        Fixed k = (Fixed(3) - (c*c + s*s)) * half;
+        c *= k;
+        s *= k;
+
+        _drive->lineTo(cx + (ax*c + bx*s).toInt(), cy + (ay*c + by*s).toInt());
+    }
 
-    // Rotate our point
-    int xx = (int)(_cosA*x - _sinA*y);
-    int yy = (int)(_sinA*x + _cosA*y);
+    // Close the curve
+    _drive->lineTo(start.x, start.y);
 
-    // Return new point shifted
-    return {xx - newShift.x, yy - newShift.y};
+    // Updated position
+    return _drive->get();
 };
 
 /**
@@ -180,42 +168,42 @@ POS Ellipse::rotate(int x, int y){
  */
 void Ellipse::print(){
 
-    Serial.print("E(");
-    Serial.print(_cx);
-    Serial.print(",");
-    Serial.print(_cy);
-    Serial.print(",");
-    Serial.print(_a);
-    Serial.print(",");
-    Serial.print(_b);
+    uart.print(F("E("));
+    uart.print(_cx);
+    uart.print(F(","));
+    uart.print(_cy);
+    uart.print(F(","));
+    uart.print(_a);
+    uart.print(F(","));
+    uart.print(_b);
     if(_angle != 0){
-        Serial.print(",{");
-        Serial.print(_origin.x);
-        Serial.print(",");
-        Serial.print(_origin.y);
-        Serial.print("},");
-        Serial.print(_angle);
+        uart.print(F(",{"));
+        uart.print(_origin.x);
+        uart.print(F(","));
+        uart.print(_origin.y);
+        uart.print(F("},"));
+        uart.print(_angle);
 
     }
-    Serial.println(")");
+    uart.println(F(")"));
 
     _lcd->setCursor(0, 1);
-    _lcd->print("E(");
+    _lcd->print(F("E("));
     _lcd->print(_cx);
-    _lcd->print(",");
+    _lcd->print(F(","));
     _lcd->print(_cy);
-    _lcd->print(",");
+    _lcd->print(F(","));
     _lcd->print(_a);
-    _lcd->print(",");
+    _lcd->print(F(","));
     _lcd->print(_b);
     if(_angle != 0){
-        _lcd->print(",{");
+        _lcd->print(F(",{"));
         _lcd->print(_origin.x);
-        _lcd->print(",");
+        _lcd->print(F(","));
         _lcd->print(_origin.y);
-        _lcd->print("},");
+        _lcd->print(F("},"));
         _lcd->print(_angle);
 
     }
-    _lcd->print(")");
+    _lcd->print(F(")"));
 };
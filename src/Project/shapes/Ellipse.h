@@ -3,53 +3,37 @@
  *
  *  Used to draw an ellipse. Supports rotation.
  *
+ *  Without a rotation the steppers trace the ellipse a quarter at a time
+ *  (Drive::arcTo), a step at a time. Rotated ellipses are drawn as lines
+ *  through points of the curve, as few as the chord tolerance allows.
+ *
  *  @author Drew Sommer
- *  @version 1.0.3
+ *  @version 1.2.0
  *  @license MIT (https://mit-license.org)
  */
 #ifndef ELLIPSE_H
 #define ELLIPSE_H
 #include "Shape.h"
 #include "../stepper/POS.h"
+#include "../lib/Fixed.h"
+
+// Most lines a rotated ellipse is drawn with. The largest takes about 800
+// for SHAPE_TOLERANCE, this keeps the count in range should the step for
+// the tolerance round down to nothing.
+#define ELLIPSE_LINES 1024
 
 /**
  * Draws an ellipse
  */
 class Ellipse: public Shape {
-private:
+protected:
     int _cx;                     // Centre x
     int _cy;                     // Centre y
     int _a;                      // a width
     int _b;                      // b height
-    double _cosA = 0;            // Rotation value cos
-    double _sinA = 0;            // Rotation value sin
-    bool _rotatedValues = false; // If already rotated
 
     POS _origin;       // Origin to rotate by
-    double _angle = 0; // Angle to rotate (radians)
-
-    /**
-     * Rotate the ellipse by the origin point, point by point
-     * @param  x
-     * @param  y
-     * @return   Updated position
-     *
-     Latex:
-    $$
-    \left[
-    \begin{array}{cc}
-    \cos\theta & -\sin\theta \\
-    \sin\theta & \cos\theta
-    \end{array}
-    \right]
-    \left[
-    \begin{array}{c}
-    x \\ y
-    \end{array}
-    \right]
-    $$
-     */
-    POS rotate(int x, int y);
+    int _angle = 0;    // Angle to rotate (degrees)
 
 public:
 
@@ -64,10 +48,8 @@ public:
      * @param cy    Centre y position
      * @param a     width
      * @param b     height
-     * @param drive Drive controller
-     * @param lcd   LCD screen controller
      */
-    Ellipse(int cx, int cy, int a, int b, Drive *drive, LiquidCrystal *lcd);
+    Ellipse(int cx, int cy, int a, int b);
 
     /**
      * Create an Ellipse with a rotation
@@ -76,11 +58,9 @@ public:
      * @param a      width
      * @param b      height
      * @param origin (x,y) to rotate by
-     * @param angle  angle of rotation (radians)
-     * @param drive  Drive controller
-     * @param lcd    LCD screen controller
+     * @param angle  angle of rotation (degrees)
      */
-    Ellipse(int cx, int cy, int a, int b, POS origin, double angle, Drive *drive, LiquidCrystal *lcd);
+    Ellipse(int cx, int cy, int a, int b, POS origin, int angle);
 
     /**
      * Draw the Ellipse
@@ -89,8 +69,29 @@ public:
      *
      * Latex:
      $$
-     y = \pm\frac{b}{a}\sqrt{a^2 - x^2} \\
-     (x + cx, y+ cy)
+     \left[
+     \begin{array}{c}
+     x \\ y
+     \end{array}
+     \right]
+     =
+     \left[
+     \begin{array}{cc}
+     \cos\theta & -\sin\theta \\
+     \sin\theta & \cos\theta
+     \end{array}
+     \right]
+     \left[
+     \begin{array}{c}
+     a\cos t \\ b\sin t
+     \end{array}
+     \right]
+     +
+     \left[
+     \begin{array}{c}
+     cx \\ cy
+     \end{array}
+     \right]
      $$
      */
     POS draw(bool p);
@@ -3,21 +3,36 @@
  *
  *  Draws lines between points of any length of lines.
  *
+ *  The points are read straight out of the shape's record in the ShapeTable
+ *  (int16 x, y), walked once to draw and once to print.
+ *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.3.1
  *  @license MIT (https://mit-license.org)
  */
 #include "Polygon.h"
+#include <string.h>
+
+/**
+ * Polygon with a buffer of points to draw, kept by the caller until drawn
+ * @param points Points to draw (packed int16 x, y)
+ * @param count  Number of points
+ */
+Polygon::Polygon(const uint8_t *points, unsigned int count):
+    Shape(),
+    _points(points),
+    _count(count) {};
 
 /**
- * Polygon with a list of points to draw
- * @param points List<POS> points to draw
- * @param drive  Drive controller
- * @param lcd    LCD screen controller
+ * Get a point, the buffer is packed so it may not be aligned
+ * @param  i Index
+ * @return   Point
  */
-Polygon::Polygon(LinkedList<POS> *points, Drive *drive, LiquidCrystal * lcd):
-    Shape(drive, lcd),
-    _points(points) {};
+POS Polygon::point(unsigned int i) {
+    int16_t xy[2];
+    memcpy(xy, _points + i * sizeof(xy), sizeof(xy));
+    return { xy[0], xy[1] };
+};
 
 /**
  * Draw from point to point
@@ -28,20 +43,17 @@ POS Polygon::draw(bool p=false) {
 
     if(p) print();
 
+    if(_count == 0) return _drive->get();
+
     // Move to our first point (point[0] is moveTo not line to).
     // To close a Polygon repeat the first point at the end.
-    _drive->moveTo(_points->get(0).x, _points->get(0).y);
+    POS start = point(0);
+    _drive->moveTo(start.x, start.y);
 
     // Loop through the points
-    for(int i=1; i<_points->size(); i++) {
-        POS point = _points->get(i);      // Get a point
-        _drive->lineTo(point.x, point.y); // Draw to the point
-
-    }
-
-    // Remove points, cleaning up some memory
-    for(int i=0; i<_points->size(); i++){
-        _points->remove(0);
+    for(unsigned int i=1; i<_count; i++) {
+        POS pos = point(i);           // Get a point
+        _drive->lineTo(pos.x, pos.y); // Draw to the point
     }
 
     // Updated position
@@ -52,39 +64,30 @@ POS Polygon::draw(bool p=false) {
  * Print details to lcd and Serial
  */
 void Polygon::print() {
-    Serial.print("P(");
+    uart.print(F("P("));
     _lcd->setCursor(0, 1);
-    _lcd->print("P(");
+    _lcd->print(F("P("));
 
-    for(int i=0; i<_points->size(); i++){
-        if(i == _points->size()-1){
+    for(unsigned int i=0; i<_count; i++){
+        POS pos = point(i);
 
-            Serial.print("{");
-            Serial.print(_points->get(i).x);
-            Serial.print(",");
-            Serial.print(_points->get(i).y);
-            Serial.print("}");
-
-            _lcd->print("{");
-            _lcd->print(_points->get(i).x);
-            _lcd->print(",");
-            _lcd->print(_points->get(i).y);
-            _lcd->print("}");
+        if(i > 0) {
+            uart.print(F(","));
+            _lcd->print(F(","));
+        }
 
-        } else {
-            Serial.print("{");
-            Serial.print(_points->get(i).x);
-            Serial.print(",");
-            Serial.print(_points->get(i).y);
-            Serial.print("},");
+        uart.print(F("{"));
+        uart.print(pos.x);
+        uart.print(F(","));
+        uart.print(pos.y);
+        uart.print(F("}"));
 
-            _lcd->print("{");
-            _lcd->print(_points->get(i).x);
-            _lcd->print(",");
-            _lcd->print(_points->get(i).y);
-            _lcd->print("},");
-        }
+        _lcd->print(F("{"));
+        _lcd->print(pos.x);
+        _lcd->print(F(","));
+        _lcd->print(pos.y);
+        _lcd->print(F("}"));
     }
-    Serial.println(")");
-    _lcd->print(")");
+    uart.println(F(")"));
+    _lcd->print(F(")"));
 };
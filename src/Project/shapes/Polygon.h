@@ -3,22 +3,33 @@
  *
  *  Draws lines between points of any length of lines.
  *
+ *  The points are read straight out of the shape's record in the ShapeTable
+ *  (int16 x, y), walked once to draw and once to print.
+ *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.3.0
  *  @license MIT (https://mit-license.org)
  */
 #ifndef POLYGON_H
 #define POLYGON_H
-#include <LinkedList.h>
 #include "./Shape.h"
 #include "../stepper/POS.h"
+#include <stdint.h>
 
 /**
  * Polygon draws a shape with straight lines between 2 points. With N points.
  */
 class Polygon: public Shape {
 private:
-    LinkedList<POS> *_points; // Points to draw between, first point is moveTo
+    const uint8_t *_points = NULL; // Points to draw between (packed int16 x, y), first point is moveTo
+    unsigned int _count = 0;       // Number of points
+
+    /**
+     * Get a point, the buffer is packed so it may not be aligned
+     * @param  i Index
+     * @return   Point
+     */
+    POS point(unsigned int i);
 
 public:
     /**
@@ -27,12 +38,11 @@ public:
     Polygon(){};
 
     /**
-     * Polygon with a list of points to draw
-     * @param points List<POS> points to draw
-     * @param drive  Drive controller
-     * @param lcd    LCD screen controller
+     * Polygon with a buffer of points to draw, kept by the caller until drawn
+     * @param points Points to draw (packed int16 x, y)
+     * @param count  Number of points
      */
-    Polygon(LinkedList<POS> *points, Drive *drive, LiquidCrystal *lcd);
+    Polygon(const uint8_t *points, unsigned int count);
 
     /**
      * Draw from point to point
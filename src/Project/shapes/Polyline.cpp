@@ -0,0 +1,112 @@
+/**
+ *  Polyline.cpp
+ *
+ *  Draws lines between points sent as deltas, for paths of many closely
+ *  spaced points.
+ *
+ *  The first point is absolute, each point after it is the step from the one
+ *  before as two zigzag varints. They are read straight out of the shape's
+ *  record in the ShapeTable, walked once to draw and once to print.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Polyline.h"
+
+/**
+ * Polyline with a buffer of deltas to draw, kept by the caller until drawn
+ * @param start  First point
+ * @param deltas Zigzag varint dx, dy of each point after it
+ * @param bytes  Bytes of deltas
+ */
+Polyline::Polyline(POS start, const uint8_t *deltas, unsigned int bytes):
+    Shape(),
+    _start(start),
+    _deltas(deltas),
+    _bytes(bytes) {};
+
+/**
+ * Read a zigzag varint
+ * @param  at Next byte, moved past the varint
+ * @param  end End of the deltas, a varint cut short ends there
+ * @return    Value
+ */
+long Polyline::delta(const uint8_t *&at, const uint8_t *end) {
+    unsigned long zigzag = 0;
+    uint8_t shift = 0;
+
+    while(at < end) {
+        uint8_t b = *at++;
+        if(shift < 32) zigzag |= (unsigned long)(b & 0x7F) << shift;
+        shift += 7;
+        if(!(b & 0x80)) break;
+    }
+
+    // 0, 1, 2, 3 .. back to 0, -1, 1, -2 ..
+    return (long)(zigzag >> 1) ^ -(long)(zigzag & 1);
+};
+
+/**
+ * Draw from point to point
+ * @param  p Print details
+ * @return   Updated position
+ */
+POS Polyline::draw(bool p=false) {
+
+    if(p) print();
+
+    // Move to our first point, the rest are lines
+    _drive->moveTo(_start.x, _start.y);
+
+    const uint8_t *at = _deltas;
+    const uint8_t *end = _deltas + _bytes;
+    POS pos = _start;
+
+    // Each point is queued as soon as it is read
+    while(at < end) {
+        pos.x += delta(at, end);
+        pos.y += delta(at, end);
+        _drive->lineTo(pos.x, pos.y);
+    }
+
+    // Updated position
+    return _drive->get();
+};
+
+/**
+ * Print details to lcd and Serial
+ */
+void Polyline::print() {
+    const uint8_t *at = _deltas;
+    const uint8_t *end = _deltas + _bytes;
+    POS pos = _start;
+
+    uart.print(F("L("));
+    _lcd->setCursor(0, 1);
+    _lcd->print(F("L("));
+
+    while(true) {
+        uart.print(F("{"));
+        uart.print(pos.x);
+        uart.print(F(","));
+        uart.print(pos.y);
+        uart.print(F("}"));
+
+        _lcd->print(F("{"));
+        _lcd->print(pos.x);
+        _lcd->print(F(","));
+        _lcd->print(pos.y);
+        _lcd->print(F("}"));
+
+        if(at >= end) break;
+
+        pos.x += delta(at, end);
+        pos.y += delta(at, end);
+
+        uart.print(F(","));
+        _lcd->print(F(","));
+    }
+    uart.println(F(")"));
+    _lcd->print(F(")"));
+};
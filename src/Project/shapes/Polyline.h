@@ -0,0 +1,76 @@
+/**
+ *  Polyline.h
+ *
+ *  Draws lines between points sent as deltas, for paths of many closely
+ *  spaced points.
+ *
+ *  The first point is absolute (int16 x, y), each point after it is the step
+ *  from the one before as two zigzag varints, dx then dy. A zigzag varint
+ *  maps 0, -1, 1, -2 .. to 0, 1, 2, 3 .. and sends 7 bits a byte, low bits
+ *  first, with the top bit set on every byte but the last. Steps of -64 to 63
+ *  take a byte. The deltas are read straight out of the shape's record in the
+ *  ShapeTable and turned into lines as they are drawn, the points are never
+ *  all held.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef POLYLINE_H
+#define POLYLINE_H
+#include "./Shape.h"
+#include "../stepper/POS.h"
+#include <stdint.h>
+
+/**
+ * Polyline draws straight lines between points sent as deltas
+ */
+class Polyline: public Shape {
+private:
+    POS _start = { 0, 0 };         // First point, moveTo
+    const uint8_t *_deltas = NULL; // Zigzag varint dx, dy of each point after it
+    unsigned int _bytes = 0;       // Bytes of deltas
+
+    /**
+     * Read a zigzag varint
+     * @param  at Next byte, moved past the varint
+     * @param  end End of the deltas, a varint cut short ends there
+     * @return    Value
+     */
+    static long delta(const uint8_t *&at, const uint8_t *end);
+
+public:
+    /**
+     * Polyline()
+     */
+    Polyline(){};
+
+    /**
+     * Polyline with a buffer of deltas to draw, kept by the caller until drawn
+     * @param start  First point
+     * @param deltas Zigzag varint dx, dy of each point after it
+     * @param bytes  Bytes of deltas
+     */
+    Polyline(POS start, const uint8_t *deltas, unsigned int bytes);
+
+    /**
+     * Draw from point to point
+     * @param  p Print details
+     * @return   Updated position
+     */
+    POS draw(bool p);
+
+    /**
+     * Draw without printing details
+     * @return Updated position
+     */
+    POS draw(){ return draw(false); };
+
+    /**
+     * Print details to lcd and Serial
+     */
+    void print();
+
+};
+
+#endif
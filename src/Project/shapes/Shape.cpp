@@ -1,30 +1,28 @@
 /**
  *  Shape.cpp
  *
- *  Base shape class. Parent to all other shapes. Used to create a list of shapes
- *  to call children Shape::draw().
+ *  Base shape class. Parent to all other shapes, holds what every shape
+ *  shares: the Drive and the LCD. Curves are drawn within SHAPE_TOLERANCE.
  *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.1.0
  *  @license MIT (https://mit-license.org)
  */
 #include "Shape.h"
 
+// Drive controller, shared by every shape
+Drive *Shape::_drive = NULL;
+
+// LCD screen controller, shared by every shape
+LiquidCrystal *Shape::_lcd = NULL;
+
 /**
- * Shape with passed parameters
+ * Set the Drive and LCD every shape draws and prints with (call within
+ * setup())
  * @param drive Drive controller
  * @param lcd   LCD screen controller
  */
-Shape::Shape(Drive *drive, LiquidCrystal *lcd): _drive(drive), _lcd(lcd){};
-
-/**
- * Draw our shape
- * @param  p Boolean, whether or not to print our details
- * @return   Updated position
- */
-POS Shape::draw(bool p=false){
-
-    if(p) print();
-
-    return _drive->get();
+void Shape::attach(Drive *drive, LiquidCrystal *lcd) {
+    _drive = drive;
+    _lcd = lcd;
 };
@@ -1,11 +1,15 @@
 /**
  *  Shape.h
  *
- *  Base shape class. Parent to all other shapes. Used to create a list of shapes
- *  to call children Shape::draw().
+ *  Base shape class. Parent to all other shapes, holds what every shape
+ *  shares: the Drive and the LCD. Curves are drawn within SHAPE_TOLERANCE.
+ *
+ *  Shapes are not kept as objects. They wait in a ShapeTable as packed records,
+ *  and each shape is built on the stack from its record just to draw or print
+ *  it, so there is no vtable and no Drive or LCD pointer per shape.
  *
  *  @author Drew Sommer
- *  @version 1.0.2
+ *  @version 1.1.1
  *  @license MIT (https://mit-license.org)
  */
 #ifndef SHAPE_H
@@ -13,61 +17,38 @@
 #include "../stepper/POS.h"
 #include "../Drive.h"
 #include "../lib/ShiftedLCD.h"
+#include "../lib/Fixed.h"
+#include "../lib/Uart.h"
+
+// How far a line may stray from the curve it stands in for (1/4 step, raw
+// Fixed). Smaller is smoother but queues more lines.
+#define SHAPE_TOLERANCE (FIXED_ONE / 4)
 
 class Drive;
 
 /**
- * Shape parent class used for looping through many subclass shapes
+ * Shape parent class, the services shared by every shape
  */
 class Shape {
 private:
 
 public:
 
-    Drive *_drive; // Drive controller, accessible by subclasses
-    LiquidCrystal *_lcd;
-
-    /**
-     * Shape()
-     */
-    Shape(){};
+    static Drive *_drive;       // Drive controller, shared by every shape
+    static LiquidCrystal *_lcd; // LCD screen controller, shared by every shape
 
     /**
-     * Shape with passed parameters
+     * Set the Drive and LCD every shape draws and prints with (call within
+     * setup())
      * @param drive Drive controller
      * @param lcd   LCD screen controller
      */
-    Shape(Drive *drive, LiquidCrystal *lcd);
-
-    /**
-     * Destructor
-     */
-    ~Shape(){};
+    static void attach(Drive *drive, LiquidCrystal *lcd);
 
     /**
-     * Draw our shape
-     * @param  p Boolean, whether or not to print our details
-     * @return   Updated position
-     */
-    virtual POS draw(bool p);
-
-    /**
-     * Draw our shape (without printing details)
-     * @return Updated position
-     */
-    virtual POS draw(){ return draw(false); };
-
-    // Virtual allows for polymorphism and creating an array of shapes (Ellipses,
-    // Circles, Etc.) and call their respective draw functions.
-
-    /**
-     * Print shape info to client/lcd
+     * Shape()
      */
-    virtual void print(){
-        _lcd->setCursor(0,1);
-        _lcd->print("Shape()");
-        Serial.println("Shape()");
-    };
+    Shape(){};
 };
 
 #endif
@@ -0,0 +1,282 @@
+/**
+ *  ShapeTable.cpp
+ *
+ *  Shapes waiting to be drawn, as packed records in a ring buffer. Each record
+ *  is a type byte and the shape's values (int16), polygons add their value
+ *  count after the type, polylines the bytes of their deltas (after the
+ *  first point). One dispatcher builds the shape for a record on the
+ *  stack to draw or print it. Speed limits are records too, so they take
+ *  effect in order with the shapes around them.
+ *
+ *  @author Drew Sommer
+ *  @version 1.3.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include "ShapeTable.h"
+#include "Circle.h"
+#include "Ellipse.h"
+#include "Bezier.h"
+#include "Polygon.h"
+#include "Polyline.h"
+#include <string.h>
+
+/**
+ * Number of values a record of a type holds
+ * @param  type SHAPE_ type
+ * @return      Values, 0 for polygons (any even number) or an unknown type
+ */
+uint8_t ShapeTable::values(uint8_t type) {
+    switch(type) {
+        case SHAPE_CIRCLE:  return 3;
+        case SHAPE_ELLIPSE: return 4;
+        case SHAPE_BEZIER:  return 8;
+        case SHAPE_ROTATED: return 7;
+        case SHAPE_FEED:    return 3;
+        case SHAPE_RAPID:   return 3;
+    }
+    return 0;
+};
+
+/**
+ * Bytes a record takes
+ * @param  record Record
+ * @return        Bytes
+ */
+size_t ShapeTable::size(uint8_t *record) {
+    uint16_t n;
+
+    if(record[0] != SHAPE_POLYGON && record[0] != SHAPE_POLYLINE) {
+        return 1 + values(record[0]) * sizeof(int16_t);
+    }
+
+    memcpy(&n, record + 1, sizeof(uint16_t));
+    if(record[0] == SHAPE_POLYLINE) return 1 + sizeof(uint16_t) + 2 * sizeof(int16_t) + n;
+    return 1 + sizeof(uint16_t) + n * sizeof(int16_t);
+};
+
+/**
+ * Add a record to the end of the table, then fill it with set()
+ * @param  type SHAPE_ type
+ * @param  n    Number of values (polygons only, 2 a point), bytes of
+ *              deltas for polylines
+ * @return      false if there is not room
+ */
+bool ShapeTable::add(uint8_t type, unsigned int n) {
+    size_t head = 1;
+    size_t bytes;
+
+    // Polygons and polylines carry their size, everything else is known from
+    // the type
+    if(type == SHAPE_POLYGON || type == SHAPE_POLYLINE) head += sizeof(uint16_t);
+    else n = values(type);
+
+    if(type == SHAPE_POLYLINE) bytes = head + 2 * sizeof(int16_t) + n;
+    else bytes = head + n * sizeof(int16_t);
+    size_t at = _head;
+
+    // Fits before the end, or else at the start ahead of the tail
+    if(!_wrapped && SHAPE_TABLE_SIZE - _head < bytes) {
+        if(_tail < bytes) return false;
+        _end = _head;
+        _wrapped = true;
+        at = 0;
+    } else if(_wrapped && _tail - _head < bytes) {
+        return false;
+    }
+
+    uint8_t *record = &_buffer[at];
+    _head = at + bytes;
+    _used += bytes;
+    if(_used > _peak) _peak = _used;
+
+    record[0] = type;
+    if(type == SHAPE_POLYGON || type == SHAPE_POLYLINE) {
+        uint16_t count = n;
+        memcpy(record + 1, &count, sizeof(uint16_t));
+    }
+
+    _open = record + head;
+    _count++;
+
+    return true;
+};
+
+/**
+ * Set a value of the record last added
+ * @param i     Index
+ * @param value Value
+ */
+void ShapeTable::set(unsigned int i, int value) {
+    int16_t v = value;
+    memcpy(_open + i * sizeof(int16_t), &v, sizeof(int16_t));
+};
+
+/**
+ * Set the deltas of the polyline last added (after its first point)
+ * @param deltas Deltas
+ * @param n      Bytes
+ */
+void ShapeTable::setDeltas(const uint8_t *deltas, unsigned int n) {
+    memcpy(_open + 2 * sizeof(int16_t), deltas, n);
+};
+
+/**
+ * Draw or print the shape of a record
+ * @param  record Record
+ * @param  draw   Draw (true) or only print (false)
+ * @param  p      Print details while drawing
+ * @return        The record after it
+ */
+uint8_t *ShapeTable::visit(uint8_t *record, bool draw, bool p) {
+    uint8_t type = *record++;
+
+    // Polygons are drawn straight from the record
+    if(type == SHAPE_POLYGON) {
+        uint16_t n;
+        memcpy(&n, record, sizeof(uint16_t));
+        record += sizeof(uint16_t);
+
+        Polygon polygon(record, n / 2);
+        if(draw) polygon.draw(p);
+        else polygon.print();
+
+        return record + n * sizeof(int16_t);
+    }
+
+    // Polylines are decoded from the record as they are drawn
+    if(type == SHAPE_POLYLINE) {
+        uint16_t n;
+        int16_t xy[2];
+        memcpy(&n, record, sizeof(uint16_t));
+        memcpy(xy, record + sizeof(uint16_t), sizeof(xy));
+        record += sizeof(uint16_t) + sizeof(xy);
+
+        Polyline polyline({ xy[0], xy[1] }, record, n);
+        if(draw) polyline.draw(p);
+        else polyline.print();
+
+        return record + n;
+    }
+
+    // Everything else is a handful of values, copy them out
+    int16_t raw[SHAPE_VALUES];
+    int v[SHAPE_VALUES];
+    uint8_t n = values(type);
+    memcpy(raw, record, n * sizeof(int16_t));
+    for(uint8_t i = 0; i < n; i++) v[i] = raw[i];
+
+    switch(type) {
+        case SHAPE_CIRCLE: {
+            Circle circle(v[0], v[1], v[2]);
+            if(draw) circle.draw(p);
+            else circle.print();
+            break;
+        }
+        case SHAPE_ELLIPSE: {
+            Ellipse ellipse(v[0], v[1], v[2], v[3]);
+            if(draw) ellipse.draw(p);
+            else ellipse.print();
+            break;
+        }
+        case SHAPE_ROTATED: {
+            Ellipse ellipse(v[0], v[1], v[2], v[3], { v[4], v[5] }, v[6]);
+            if(draw) ellipse.draw(p);
+            else ellipse.print();
+            break;
+        }
+        case SHAPE_BEZIER: {
+            Bezier bezier({ v[0], v[1] }, { v[2], v[3] }, { v[4], v[5] }, { v[6], v[7] });
+            if(draw) bezier.draw(p);
+            else bezier.print();
+            break;
+        }
+        case SHAPE_FEED:
+        case SHAPE_RAPID: {
+            if(!draw || p) {
+                uart.print(type == SHAPE_FEED ? F("F(") : F("R("));
+                uart.print(v[0]);
+                uart.print(F(","));
+                uart.print(v[1]);
+                uart.print(F(","));
+                uart.print(v[2]);
+                uart.println(F(")"));
+            }
+            if(!draw) break;
+
+            // Nothing under 1 step/s, and no faster than the steppers go
+            Profile speed = {
+                (unsigned int)min(v[0], PROFILE_MAX_SPEED),
+                (unsigned int)min(v[1], PROFILE_MAX_SPEED),
+                (unsigned int)min(v[2], PROFILE_MAX_ACCEL)
+            };
+
+            if(v[0] <= 0 || v[1] < v[0] || v[2] <= 0) {
+                uart.println(F("Bad speed limits"));
+            } else if(type == SHAPE_FEED) {
+                Shape::_drive->setProfile(speed, speed);
+            } else {
+                Shape::_drive->setRapid(speed, speed);
+            }
+            break;
+        }
+    }
+
+    return record + n * sizeof(int16_t);
+};
+
+/**
+ * Draw the oldest shape and drop it, making room for more
+ * @param  p Print details of the shape
+ * @return   false if there was nothing to draw
+ */
+bool ShapeTable::draw(bool p) {
+    if(_count == 0) return false;
+
+    uint8_t *record = &_buffer[_tail];
+    size_t bytes = size(record);
+    visit(record, true, p);
+
+    _tail += bytes;
+    _used -= bytes;
+    _count--;
+
+    // Empty, start over at the start. Past the last record before the end,
+    // carry on from the start.
+    if(_count == 0) {
+        _head = 0;
+        _tail = 0;
+        _wrapped = false;
+    } else if(_wrapped && _tail == _end) {
+        _tail = 0;
+        _wrapped = false;
+    }
+
+    return true;
+};
+
+/**
+ * Bytes of records that are sure to fit, however they fall against the
+ * end of the buffer. Only grows as shapes are drawn.
+ * @return Bytes
+ */
+size_t ShapeTable::room() {
+
+    // Wrapped, only the gap up to the oldest record is left
+    if(_wrapped) return _tail - _head;
+
+    // Records fill to the end of the buffer, the first one that does not fit
+    // goes to the start, so whichever space is bigger takes them all
+    return max(SHAPE_TABLE_SIZE - _head, _tail);
+};
+
+/**
+ * Print details of every shape in the order added
+ */
+void ShapeTable::print() {
+    size_t at = _tail;
+
+    for(unsigned int i=0; i<_count; i++) {
+        if(_wrapped && at == _end) at = 0;
+        at = visit(&_buffer[at], false, false) - _buffer;
+    }
+};
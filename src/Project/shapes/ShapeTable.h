@@ -0,0 +1,152 @@
+/**
+ *  ShapeTable.h
+ *
+ *  Shapes waiting to be drawn, as packed records in a ring buffer. Each record
+ *  is a type byte and the shape's values (int16), polygons add their value
+ *  count after the type, polylines the bytes of their deltas (after the
+ *  first point). One dispatcher builds the shape for a record on the
+ *  stack to draw or print it. Speed limits are records too, so they take
+ *  effect in order with the shapes around them.
+ *
+ *  Shapes are added at the head while the oldest is drawn and dropped from the
+ *  tail, so receiving and drawing overlap. A record is never split: one that
+ *  does not fit before the end of the buffer goes to the start and the end is
+ *  skipped until the tail wraps to it.
+ *
+ *  Bytes per shape (the same on any build, as in a frame but for the polygon
+ *  count):
+ *    Circle 7, Ellipse 9, rotated Ellipse 15, Bezier 17, Polygon 3 + 4 a point,
+ *    Polyline 7 + the deltas (often 2 a point), speed limits 7
+ *
+ *  @author Drew Sommer
+ *  @version 1.3.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef SHAPETABLE_H
+#define SHAPETABLE_H
+#include <stdint.h>
+#include <stddef.h>
+
+// Record types (first byte) and the values that follow
+#define SHAPE_CIRCLE   1 // cx, cy, r
+#define SHAPE_ELLIPSE  2 // cx, cy, a, b
+#define SHAPE_BEZIER   3 // p0.x, p0.y, p1.x, p1.y, p2.x, p2.y, p3.x, p3.y
+#define SHAPE_POLYGON  4 // (value count) x, y of each point
+#define SHAPE_ROTATED  5 // cx, cy, a, b, origin.x, origin.y, angle (degrees)
+#define SHAPE_FEED     6 // start, speed, accel of the moves drawn after it
+#define SHAPE_RAPID    7 // start, speed, accel of the pen up moves after it
+#define SHAPE_POLYLINE 8 // (delta bytes) x, y of the first point, then the
+                         // deltas (see Polyline.h)
+
+// Bytes for the records
+#define SHAPE_TABLE_SIZE 256
+
+// Most values of a fixed size record
+#define SHAPE_VALUES 8
+
+/**
+ * Ring buffer of packed shape records
+ */
+class ShapeTable {
+private:
+    uint8_t _buffer[SHAPE_TABLE_SIZE]; // Records, one after the other
+    size_t _head = 0;         // Where the next record goes
+    size_t _tail = 0;         // Oldest record
+    size_t _end = 0;          // End of the records before the start (wrapped)
+    bool _wrapped = false;    // The head has gone back to the start
+    size_t _used = 0;         // Bytes in records
+    size_t _peak = 0;         // Most bytes ever in records
+    uint8_t *_open = NULL;    // Values of the record being filled by set()
+    unsigned int _count = 0;  // Records in the table
+
+    /**
+     * Bytes a record takes
+     * @param  record Record
+     * @return        Bytes
+     */
+    static size_t size(uint8_t *record);
+
+    /**
+     * Draw or print the shape of a record
+     * @param  record Record
+     * @param  draw   Draw (true) or only print (false)
+     * @param  p      Print details while drawing
+     * @return        The record after it
+     */
+    uint8_t *visit(uint8_t *record, bool draw, bool p);
+
+public:
+    /**
+     * ShapeTable()
+     */
+    ShapeTable(){};
+
+    /**
+     * Number of values a record of a type holds
+     * @param  type SHAPE_ type
+     * @return      Values, 0 for polygons (any even number) or an unknown type
+     */
+    static uint8_t values(uint8_t type);
+
+    /**
+     * Add a record to the end of the table, then fill it with set()
+     * @param  type SHAPE_ type
+     * @param  n    Number of values (polygons only, 2 a point), bytes of
+     *              deltas for polylines
+     * @return      false if there is not room
+     */
+    bool add(uint8_t type, unsigned int n);
+
+    /**
+     * Set a value of the record last added
+     * @param i     Index
+     * @param value Value
+     */
+    void set(unsigned int i, int value);
+
+    /**
+     * Set the deltas of the polyline last added (after its first point)
+     * @param deltas Deltas
+     * @param n      Bytes
+     */
+    void setDeltas(const uint8_t *deltas, unsigned int n);
+
+    /**
+     * Draw the oldest shape and drop it, making room for more
+     * @param  p Print details of the shape
+     * @return   false if there was nothing to draw
+     */
+    bool draw(bool p);
+
+    /**
+     * Print details of every shape in the order added
+     */
+    void print();
+
+    /**
+     * Number of shapes in the table
+     * @return count
+     */
+    unsigned int count(){ return _count; };
+
+    /**
+     * Bytes of records that are sure to fit, however they fall against the
+     * end of the buffer. Only grows as shapes are drawn.
+     * @return Bytes
+     */
+    size_t room();
+
+    /**
+     * Bytes in records
+     * @return Bytes
+     */
+    size_t used(){ return _used; };
+
+    /**
+     * Most bytes ever in records (high-water mark)
+     * @return Bytes
+     */
+    size_t peak(){ return _peak; };
+};
+
+#endif
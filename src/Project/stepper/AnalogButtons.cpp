@@ -3,13 +3,30 @@
  *
  *  Manages input on a single pin for multiple buttons (2)
  *
+ *  The ADC runs from its conversion complete interrupt, taking turns on the
+ *  pins of every attached AnalogButtons. Each reading is debounced into a
+ *  cached state, so check() only reads a byte and is safe to call from the
+ *  step interrupt.
+ *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.1.0
  *  @license MIT (https://mit-license.org)
  */
 #include <Arduino.h>
 #include "AnalogButtons.h"
 
+AnalogButtons *AnalogButtons::_list[ANALOG_BUTTONS_MAX];
+uint8_t AnalogButtons::_size = 0;
+uint8_t AnalogButtons::_cur = 0;
+volatile bool AnalogButtons::_paused = false;
+
+/**
+ * ADC conversion complete
+ */
+ISR(ADC_vect) {
+    AnalogButtons::isr();
+}
+
 /**
  * Library to interpret analog input for multiple buttons on a single pin
  * @param pin  The pin monitor
@@ -25,13 +42,66 @@ AnalogButtons::AnalogButtons(int pin, int btn1, int btn2, int buff)
       _buff(buff){}
 
 /**
- * Checks the current analog pins voltage
- * @return Returns the -1 for button 1, 1 for button 2, or 0 for neither
+ * Add the buttons to the ADC interrupt (call within setup())
+ */
+void AnalogButtons::attach() {
+    if(_size >= ANALOG_BUTTONS_MAX) return;
+
+    noInterrupts();
+    _list[_size] = this;
+    _size++;
+
+    // First one in starts the conversions. /128 prescaler, ~104us each
+    if(_size == 1) {
+        _cur = 0;
+        ADCSRA = _BV(ADEN) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+        start();
+    }
+    interrupts();
+}
+
+/**
+ * Start a conversion on the current button's pin
+ */
+void AnalogButtons::start() {
+    ADMUX = _BV(REFS0) | (_list[_cur]->_pin & 0x07); // AVcc reference
+    ADCSRA |= _BV(ADSC);
+}
+
+/**
+ * ADC conversion complete interrupt handler, do not call
  */
-int AnalogButtons::check() {
+void AnalogButtons::isr() {
+    int ch = ADC;
 
-    // Read our pin
-    int ch = analogRead(_pin);
+    // sample() is using the ADC, it restarts us when done
+    if(_paused) return;
+
+    // Debounce, the state only changes once enough readings agree
+    AnalogButtons *btn = _list[_cur];
+    int8_t raw = btn->classify(ch);
+
+    if(raw != btn->_raw) {
+        btn->_raw = raw;
+        btn->_count = 1;
+
+    } else if(btn->_count < ANALOG_BUTTONS_DEBOUNCE) {
+        btn->_count++;
+        if(btn->_count == ANALOG_BUTTONS_DEBOUNCE) btn->_state = raw;
+    }
+
+    // Next buttons turn
+    _cur++;
+    if(_cur >= _size) _cur = 0;
+    start();
+}
+
+/**
+ * Work out which button a reading is
+ * @param  ch ADC reading (0-1023)
+ * @return    -1 for button 1, 1 for button 2, or 0 for neither
+ */
+int8_t AnalogButtons::classify(int ch) {
 
     // Check if our first button is pressed
     if(_btn1 - _buff <= ch && ch < _btn1 + _buff) {
@@ -45,3 +115,32 @@ int AnalogButtons::check() {
     // No button is pressed
     return 0;
 }
+
+/**
+ * Blocking analogRead() of another pin, use instead of analogRead() once
+ * buttons are attached
+ * @param  pin Analog pin
+ * @return     Reading (0-1023)
+ */
+int AnalogButtons::sample(int pin) {
+    if(_size == 0) return analogRead(pin);
+
+    // Park the button conversions, let the one running finish
+    _paused = true;
+    while(ADCSRA & _BV(ADSC));
+
+    // analogRead() polls, keep the interrupt out of it
+    noInterrupts();
+    ADCSRA &= ~_BV(ADIE);
+    interrupts();
+    int value = analogRead(pin);
+
+    // Clear the finished flag and carry on with the buttons
+    noInterrupts();
+    ADCSRA |= _BV(ADIF) | _BV(ADIE);
+    _paused = false;
+    start();
+    interrupts();
+
+    return value;
+}
@@ -3,12 +3,24 @@
  *
  *  Manages input on a single pin for multiple buttons (2)
  *
+ *  The ADC runs from its conversion complete interrupt, taking turns on the
+ *  pins of every attached AnalogButtons. Each reading is debounced into a
+ *  cached state, so check() only reads a byte and is safe to call from the
+ *  step interrupt.
+ *
  *  @author Drew Sommer
- *  @version 1.0.0
+ *  @version 1.1.0
  *  @license MIT (https://mit-license.org)
  */
 #ifndef ANALOGBUTTONS_H
 #define ANALOGBUTTONS_H
+#include <stdint.h>
+
+// Most AnalogButtons the ADC interrupt takes turns on
+#define ANALOG_BUTTONS_MAX 4
+
+// Readings in a row that must agree before the state changes
+#define ANALOG_BUTTONS_DEBOUNCE 4
 
 /**
  * Library to interpret analog input for multiple buttons on a single pin
@@ -23,6 +35,27 @@ private:
     int _btn2;
     int _buff = 50;
 
+    volatile int8_t _state = 0; // Debounced state (-1, 1, 0)
+    int8_t _raw = 0;            // State of the last reading
+    uint8_t _count = 0;         // Readings in a row that matched _raw
+
+    static AnalogButtons *_list[ANALOG_BUTTONS_MAX]; // Attached buttons
+    static uint8_t _size;                            // Number attached
+    static uint8_t _cur;                             // Being converted
+    static volatile bool _paused;                    // sample() has the ADC
+
+    /**
+     * Start a conversion on the current button's pin
+     */
+    static void start();
+
+    /**
+     * Work out which button a reading is
+     * @param  ch ADC reading (0-1023)
+     * @return    -1 for button 1, 1 for button 2, or 0 for neither
+     */
+    int8_t classify(int ch);
+
 public:
     /**
      * Library to interpret analog input for multiple buttons on a single pin
@@ -35,10 +68,28 @@ public:
     AnalogButtons(int pin, int btn1, int btn2, int buff);
 
     /**
-     * Checks the current analog pins voltage
+     * Add the buttons to the ADC interrupt (call within setup())
+     */
+    void attach();
+
+    /**
+     * Last debounced state of the buttons
      * @return Returns the -1 for button 1, 1 for button 2, or 0 for neither
      */
-    int check();
+    int check(){ return _state; };
+
+    /**
+     * ADC conversion complete interrupt handler, do not call
+     */
+    static void isr();
+
+    /**
+     * Blocking analogRead() of another pin, use instead of analogRead() once
+     * buttons are attached
+     * @param  pin Analog pin
+     * @return     Reading (0-1023)
+     */
+    static int sample(int pin);
 };
 
 #endif
@@ -0,0 +1,98 @@
+/**
+ *  Arc.cpp
+ *
+ *  Steps out a quarter of an axis-aligned ellipse one step at a time, the
+ *  midpoint (Bresenham) way. Each step moves along u, v or both, whichever
+ *  keeps closest to the curve, using only integer adds and compares so it is
+ *  cheap enough to run per step from the step interrupt.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Arc.h"
+#include "../lib/Fixed.h"
+
+/**
+ * Start a new quarter
+ * @param a Semi-axis along u (steps)
+ * @param b Semi-axis along v (steps)
+ */
+void Arc::begin(unsigned int a, unsigned int b) {
+    int64_t aa = (int32_t)a * a;
+    int64_t bb = (int32_t)b * b;
+
+    _u = a;
+    _v = b;
+    _a2 = 2 * aa;
+    _b2 = 2 * bb;
+
+    // Start at (-a, 0), error of stepping to (-a + 1, 1)
+    //   f(u, v) = b^2 u^2 + a^2 v^2 - a^2 b^2
+    _du = (1 - 2 * (int64_t)a) * bb;
+    _dv = aa;
+    _err = _du + _dv;
+};
+
+/**
+ * Get the next step, call once per step
+ * @return ARC_U and/or ARC_V, 0 once done
+ */
+uint8_t Arc::next() {
+
+    // On an axis the rest is a straight run
+    if(_u == 0) {
+        if(_v == 0) return 0;
+        _v--;
+        return ARC_V;
+    }
+    if(_v == 0) {
+        _u--;
+        return ARC_U;
+    }
+
+    uint8_t step = 0;
+    int64_t e2 = 2 * _err;
+
+    // Stepping u brings the error down more than it overshoots (e_xy + e_x > 0)
+    if(e2 >= _du) {
+        _u--;
+        _du += _b2;
+        _err += _du;
+        step |= ARC_U;
+    }
+
+    // Stepping v does (e_xy + e_y < 0)
+    if(e2 <= _dv) {
+        _v--;
+        _dv += _a2;
+        _err += _dv;
+        step |= ARC_V;
+    }
+
+    return step;
+};
+
+/**
+ * Radius of the curve at a point of the quarter
+ *   r = (a^4 v^2 + b^4 u^2)^(3/2) / (a^4 b^4) = h^3 / ab
+ *   h^2 = (a v / b)^2 + (b u / a)^2
+ * @param  a Semi-axis along u (steps, less than 16384)
+ * @param  b Semi-axis along v (steps, less than 16384)
+ * @param  u Distance from the v axis (steps, 0 to a)
+ * @param  v Distance from the u axis (steps, 0 to b)
+ * @return   Radius (steps, 65535 at most)
+ */
+unsigned int Arc::radius(unsigned int a, unsigned int b, unsigned int u, unsigned int v) {
+    unsigned long p = (unsigned long)a * v / b;
+    unsigned long q = (unsigned long)b * u / a;
+    unsigned long h = Fixed::isqrt(p * p + q * q);
+    if(h == 0) return 0;
+
+    // h^3 / ab, a step at a time so it can not overflow
+    unsigned long r = h * h / a;
+    if(r > 0xFFFFFFFFUL / h) return 0xFFFF;
+    r = r * h / b;
+
+    return r > 0xFFFF ? 0xFFFF : r;
+};
@@ -0,0 +1,72 @@
+/**
+ *  Arc.h
+ *
+ *  Steps out a quarter of an axis-aligned ellipse one step at a time, the
+ *  midpoint (Bresenham) way. Each step moves along u, v or both, whichever
+ *  keeps closest to the curve, using only integer adds and compares so it is
+ *  cheap enough to run per step from the step interrupt.
+ *
+ *  The quarter runs in its own (u, v) frame: from (-a, 0), the tip of the u
+ *  axis, to (0, b), the tip of the v axis. It leaves along v and arrives
+ *  along u. The Drive maps u and v onto x and y.
+ *
+ *  Based on the ellipse rasterizer in A. Zingl, "A Rasterizing Algorithm for
+ *  Drawing Curves" (2012).
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef ARC_H
+#define ARC_H
+#include <stdint.h>
+
+// Step bits handed out by next()
+#define ARC_U 1 // Step along u
+#define ARC_V 2 // Step along v
+
+/**
+ * Midpoint stepper for a quarter ellipse
+ */
+class Arc {
+private:
+    int64_t _err = 0; // Error (off the curve) of the next diagonal step
+    int64_t _du = 0;  // Error added by the next u step, (2u + 1) b^2
+    int64_t _dv = 0;  // Error added by the next v step, (2v + 1) a^2
+    int32_t _a2 = 0;  // 2 a^2
+    int32_t _b2 = 0;  // 2 b^2
+    unsigned int _u = 0; // Steps left along u
+    unsigned int _v = 0; // Steps left along v
+
+public:
+    /**
+     * Arc()
+     */
+    Arc(){};
+
+    /**
+     * Start a new quarter
+     * @param a Semi-axis along u (steps)
+     * @param b Semi-axis along v (steps)
+     */
+    void begin(unsigned int a, unsigned int b);
+
+    /**
+     * Get the next step, call once per step
+     * @return ARC_U and/or ARC_V, 0 once done
+     */
+    uint8_t next();
+
+    /**
+     * Radius of the curve at a point of the quarter
+     *   r = (a^4 v^2 + b^4 u^2)^(3/2) / (a^4 b^4)
+     * @param  a Semi-axis along u (steps, less than 16384)
+     * @param  b Semi-axis along v (steps, less than 16384)
+     * @param  u Distance from the v axis (steps, 0 to a)
+     * @param  v Distance from the u axis (steps, 0 to b)
+     * @return   Radius (steps, 65535 at most)
+     */
+    static unsigned int radius(unsigned int a, unsigned int b, unsigned int u, unsigned int v);
+};
+
+#endif
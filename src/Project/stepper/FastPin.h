@@ -0,0 +1,67 @@
+/**
+ *  FastPin.h
+ *
+ *  A digital pin fixed at compile time. Works out the port register and bit
+ *  for the pin (Arduino Uno, ATmega328P) so writes compile down to a single
+ *  sbi/cbi instruction instead of going through digitalWrite()'s lookup
+ *  tables.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef FASTPIN_H
+#define FASTPIN_H
+#include <Arduino.h>
+
+/**
+ * Digital pin with direct port access
+ * @param PIN Arduino pin number (0-19)
+ */
+template<uint8_t PIN>
+class FastPin {
+private:
+    static_assert(PIN < 20, "FastPin: the Uno only has pins 0-19");
+
+    // Bit of the pin in its port. 0-7 are PORTD, 8-13 PORTB, 14-19 (A0-A5) PORTC
+    static const uint8_t _mask = 1 << (PIN < 8 ? PIN : (PIN < 14 ? PIN - 8 : PIN - 14));
+
+    /**
+     * Output register of the pin's port
+     * @return PORTx
+     */
+    static volatile uint8_t &port(){ return PIN < 8 ? PORTD : (PIN < 14 ? PORTB : PORTC); };
+
+    /**
+     * Direction register of the pin's port
+     * @return DDRx
+     */
+    static volatile uint8_t &ddr(){ return PIN < 8 ? DDRD : (PIN < 14 ? DDRB : DDRC); };
+
+public:
+    /**
+     * Set the pin as an output (call within setup())
+     */
+    static void output(){ ddr() |= _mask; };
+
+    /**
+     * Drive the pin HIGH
+     */
+    static void high(){ port() |= _mask; };
+
+    /**
+     * Drive the pin LOW
+     */
+    static void low(){ port() &= ~_mask; };
+
+    /**
+     * Drive the pin
+     * @param value HIGH (true) or LOW (false)
+     */
+    static void write(bool value){
+        if(value) high();
+        else low();
+    };
+};
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ *  FastStepper.h
+ *
+ *  Stepper with its step, dir and enable pins fixed at compile time. Same
+ *  interface and state as Stepper, but every pin write is a single port bit
+ *  operation (see FastPin.h), so the step interrupt can run much faster than
+ *  digitalWrite() allows.
+ *
+ *  The PinMap is still taken (and kept) so the two are interchangeable, the
+ *  template pins have to match it. Pins.h holds the pins for both, and
+ *  main.cpp checks its PinMaps against them with matches() when it is built.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef FASTSTEPPER_H
+#define FASTSTEPPER_H
+#include <Arduino.h>
+#include "POS.h"
+#include "Stepper.h"
+#include "FastPin.h"
+
+/**
+ * Stepper controller for the easy driver, with compile-time pins
+ * @param STEP   Step pin
+ * @param DIR    Dir pin
+ * @param ENABLE Enable pin
+ */
+template<uint8_t STEP, uint8_t DIR, uint8_t ENABLE>
+class FastStepper: public Stepper {
+public:
+    /**
+     * Instantiate a new stepper, the PinMap's pins must match the template
+     * @param map the pins for the stepper to manage
+     * @param del delay (ms), sets the start speed of the default profile
+     */
+    FastStepper(PinMap map, int del): Stepper(map, del){};
+
+    /**
+     * The PinMap's stepper pins are the template's (for a static_assert)
+     * @param  map PinMap
+     * @return     true/false
+     */
+    static constexpr bool matches(PinMap map){
+        return map.step == STEP && map.dir == DIR && map.enable == ENABLE;
+    };
+
+    /**
+     * Used to setup the Stepper (called within steup()). Starts disabled.
+     */
+    void attach(){
+        FastPin<STEP>::output();
+        FastPin<DIR>::output();
+        FastPin<ENABLE>::output();
+
+        // Put the pins in a known state so we only write them on change
+        FastPin<DIR>::low();
+        _dirMode = false;
+        FastPin<ENABLE>::high();
+        _enableMode = true;
+    };
+
+    /**
+     * Power the driver (enable LOW), stays on till disable()
+     */
+    void enable(){
+        if(!_enableMode) return;
+        FastPin<ENABLE>::low();
+        _enableMode = false;
+    };
+
+    /**
+     * Power down the driver (enable HIGH), the motor can be moved by hand
+     */
+    void disable(){
+        if(_enableMode) return;
+        FastPin<ENABLE>::high();
+        _enableMode = true;
+    };
+
+    /**
+     * Move's the stepper forward a step, the caller times the steps. Enables
+     * the driver if it is not already.
+     * @return the new currentPos
+     */
+    int forward(){
+        enable();
+
+        // Only write dir when it changes
+        bool dir = _flip;
+        if(_dirMode != dir) {
+            FastPin<DIR>::write(dir);
+            _dirMode = dir;
+        }
+
+        FastPin<STEP>::high();
+        delayMicroseconds(STEP_PULSE);
+        FastPin<STEP>::low();
+        _currentPos++;
+
+        return _currentPos;
+    };
+
+    /**
+     * Move's the stepper backwards a step, the caller times the steps. Enables
+     * the driver if it is not already.
+     * @return the new currentPos
+     */
+    int backward(){
+        enable();
+
+        // Only write dir when it changes
+        bool dir = !_flip;
+        if(_dirMode != dir) {
+            FastPin<DIR>::write(dir);
+            _dirMode = dir;
+        }
+
+        FastPin<STEP>::high();
+        delayMicroseconds(STEP_PULSE);
+        FastPin<STEP>::low();
+        _currentPos--;
+
+        return _currentPos;
+    };
+};
+
+#endif
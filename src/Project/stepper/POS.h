@@ -9,8 +9,11 @@
  *  to the Drive, which get passed to the stepper motors. The stepper uses most
  *  of PinMap, the Drive also uses some of the values.
  *
+ *  Profile holds the speed limits of a stepper, used by the Drive to ramp the
+ *  steppers up and down on each move.
+ *
  *  @author Drew Sommer
- *  @version 1.0.0
+ *  @version 1.0.1
  *  @license MIT (https://mit-license.org)
  */
 #ifndef POS_H
@@ -44,4 +47,18 @@ struct PinMap {
     int flip;   // Boolean whether or not we flip the direction of the stepper
 };
 
+// Fastest a profile may step and ramp, what the step interrupt and the
+// steppers keep up with (steps/s, steps/s/s)
+#define PROFILE_MAX_SPEED 4000
+#define PROFILE_MAX_ACCEL 20000
+
+/**
+ * Motion profile for a stepper, all rates are in steps/s
+ */
+struct Profile {
+    unsigned int start; // Speed we can start and stop at without ramping
+    unsigned int speed; // Max (cruise) speed
+    unsigned int accel; // Acceleration (steps/s/s)
+};
+
 #endif
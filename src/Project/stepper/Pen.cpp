@@ -3,8 +3,13 @@
  *
  *  Controller for manageing the pen (servo) up and down motion for drawing.
  *
+ *  up() and down() only send the servo its new angle and return. How long the
+ *  servo takes to get there is modeled (travel time per degree plus a settle
+ *  time), ready() tells when it should be in place. Safe to call from the
+ *  step interrupt.
+ *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.1.0
  *  @license MIT (https://mit-license.org)
  */
 #include "Pen.h"
@@ -16,14 +21,13 @@
  * @param pin  The servo pin
  * @param up   The max angle (0-180)
  * @param down The min angle (0-180)
- * @param del  The delay time (ms)
+ * @param del  The travel time per degree (ms)
  */
 Pen::Pen(int pin, int up, int down, int del)
     : _pin(pin),
-      _upPos(up),
       _downPos(down),
-      _del(del),
-      _cur(up){};
+      _upPos(up),
+      _del(del){};
 
 /**
  * Attaches the Pen (call within setup())
@@ -34,20 +38,26 @@ void Pen::attach() {
 
 /**
  * Set the servo to max angle
- * @return true/false if completed
+ * @return true/false if in place
  */
 bool Pen::up() {
-    _target = _upPos; // Set target angle
-    return move();    // Move to target
+    return move(_upPos);
 }
 
 /**
  * Set the servo to min angle
- * @return true/false if completed
+ * @return true/false if in place
  */
 bool Pen::down() {
-    _target = _downPos; // Set target angle
-    return move();      // Move to target
+    return move(_downPos);
+};
+
+/**
+ * The servo has had time to get to its angle and settle
+ * @return true/false
+ */
+bool Pen::ready() {
+    return (long)(millis() - _done) >= 0;
 };
 
 /**
@@ -61,28 +71,23 @@ int Pen::setDown(int ro) {
 };
 
 /**
- * Move from the current angle to the target angle
- * @return completed (true)
+ * Send the servo to an angle, does nothing if already sent there
+ * @param  target Angle (0-180)
+ * @return        true/false if in place
  */
-bool Pen::move(){
+bool Pen::move(int target){
+
+    // Already there or on the way
+    if(target == _target) return ready();
+
+    // Travel from the last angle we sent. Where the servo starts from is not
+    // known until we have sent it somewhere, allow for the full sweep.
+    int travel = _target < 0 ? _upPos - _downPos : target - _target;
+    if(travel < 0) travel = -travel;
 
-    // Our current angle is greater than our target angle. Decrement our angle
-    // till we match our target angle.
-    if(_cur > _target){
-        for(int i=_cur; i>=_target; i--){
-            _servo.write(i);
-            _cur = i;
-            delay(_del);
-        }
+    _servo.write(target);
+    _target = target;
+    _done = millis() + (unsigned long)travel * _del + PEN_SETTLE;
 
-    // Our current angle is less than our target angle. Increment our angle till
-    // we match our target angle.
-    } else {
-        for(int i=_cur; i<=_target; i++){
-            _servo.write(i);
-            _cur = i;
-            delay(_del);
-        }
-    }
-    return true;
+    return false;
 }
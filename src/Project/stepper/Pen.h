@@ -3,14 +3,22 @@
  *
  *  Controller for manageing the pen (servo) up and down motion for drawing.
  *
+ *  up() and down() only send the servo its new angle and return. How long the
+ *  servo takes to get there is modeled (travel time per degree plus a settle
+ *  time), ready() tells when it should be in place. Safe to call from the
+ *  step interrupt.
+ *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.1.0
  *  @license MIT (https://mit-license.org)
  */
 #ifndef PEN_H
 #define PEN_H
 #include <Servo.h>
 
+// Time the servo is given to settle once it gets to its angle (ms)
+#define PEN_SETTLE 0
+
 /**
  * Pen is used to control the Arduino Servo
  * @param pin  The servo pin
@@ -19,20 +27,20 @@
  */
 class Pen {
 private:
-    bool _up = false; // Pen up or down (default down)
-    int _pin;         // Control pin
-    int _downPos;     // Min angle (0-180)
-    int _upPos;       // Max angle (0-180)
-    int _del;         // Delay time (ms)
-    int _cur;         // Current angle
-    int _target;      // Target angle
-    Servo _servo;     // Arduino servo controller
+    int _pin;                  // Control pin
+    int _downPos;              // Min angle (0-180)
+    int _upPos;                // Max angle (0-180)
+    int _del;                  // Travel time per degree (ms)
+    int _target = -1;          // Angle last sent to the servo (-1 not sent yet)
+    unsigned long _done = 0;   // Time the servo should be in place (ms)
+    Servo _servo;              // Arduino servo controller
 
     /**
-     * Move from the current angle to the target angle
-     * @return completed (true)
+     * Send the servo to an angle, does nothing if already sent there
+     * @param  target Angle (0-180)
+     * @return        true/false if in place
      */
-    bool move();
+    bool move(int target);
 
 public:
     /**
@@ -40,7 +48,7 @@ public:
      * @param pin  The servo pin
      * @param up   The max angle (0-180)
      * @param down The min angle (0-180)
-     * @param del  The delay time (ms)
+     * @param del  The travel time per degree (ms)
      */
     Pen(int pin, int up, int down, int del);
 
@@ -51,16 +59,22 @@ public:
 
     /**
      * Set the servo to max
-     * @return true/false if completed
+     * @return true/false if in place
      */
     bool up();
 
     /**
      * Set the servo to min
-     * @return true/false if completed
+     * @return true/false if in place
      */
     bool down();
 
+    /**
+     * The servo has had time to get to its angle and settle
+     * @return true/false
+     */
+    bool ready();
+
     /**
      * Set the low position (using a potentiometer)
      * @param ro read-out
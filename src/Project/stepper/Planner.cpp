@@ -0,0 +1,175 @@
+/**
+ *  Planner.cpp
+ *
+ *  Look-ahead planner for the segment queue. Works out how fast each segment
+ *  may enter from the angle it makes with the segment before it, then plans
+ *  the entry speeds over the whole queue so the steppers only slow down for
+ *  sharp corners and for the end of the queue, not at every joint of a curve.
+ *
+ *  Junction speeds use the junction deviation model: the corner is treated as
+ *  a small arc that strays at most `deviation` steps from the real corner, and
+ *  the speed is whatever keeps the acceleration around that arc in the limit.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#include <Arduino.h>
+#include "Planner.h"
+
+/**
+ * Fastest speed to go from one segment into the next
+ * @param  prev Segment before the junction
+ * @param  seg  Segment after the junction
+ * @return      Max entry speed of seg (steps/s)
+ */
+unsigned int Planner::junction(Segment *prev, Segment *seg) {
+
+    unsigned int start = max(prev->profile.start, seg->profile.start);
+    unsigned int limit = min(prev->profile.speed, seg->profile.speed);
+
+    // The pen moves between these, we have to stop
+    if(prev->up != seg->up) return start;
+
+    // Pieces of the same arc, the curve is smooth through the joint
+    if(seg->kind & SEGMENT_MORE) return limit;
+
+    // Unit directions of both segments at the junction (the dir sign is the
+    // same for both so it does not matter that forward is x-). The queued
+    // length is rounded to a step, too coarse for short segments, so take
+    // the root again.
+    int px, py, sx, sy;
+    heading(prev, true, px, py);
+    heading(seg, false, sx, sy);
+
+    // A piece of an arc that never steps along the axis it leaves or
+    // arrives on (a very flat ellipse) has no heading there, stop
+    if((px == 0 && py == 0) || (sx == 0 && sy == 0)) return start;
+
+    Fixed pl = Fixed::root((long)px * px + (long)py * py);
+    Fixed sl = Fixed::root((long)sx * sx + (long)sy * sy);
+    Fixed pu = Fixed(px) / pl;
+    Fixed pv = Fixed(py) / pl;
+    Fixed su = Fixed(sx) / sl;
+    Fixed sv = Fixed(sy) / sl;
+
+    // Cos of the angle between the reversed first direction and the second,
+    // -1 is straight on, 1 is a full reversal
+    Fixed cosT = -(pu * su + pv * sv);
+
+    if(cosT < Fixed::fromRaw(-65530)) return limit; // -0.9999
+    if(cosT > Fixed::fromRaw(65530)) return start;  // 0.9999
+
+    // Speed around an arc of deviation d touching both lines
+    //   v = sqrt(a * d * sin(T/2) / (1 - sin(T/2)))
+    Fixed sinT2 = Fixed::sqrt((Fixed(1) - cosT) * Fixed::fromRaw(FIXED_ONE / 2));
+    unsigned int accel = min(prev->profile.accel, seg->profile.accel);
+    Fixed bend = sinT2 / (Fixed(1) - sinT2);
+    unsigned long v = Fixed::isqrt(Fixed::scale(Fixed::scale(accel, bend), Fixed::fromRaw(PLANNER_DEVIATION)));
+
+    if(v < start) return start;
+    if(v > limit) return limit;
+    return (unsigned int)v;
+};
+
+/**
+ * Direction a segment heads in at one of its ends, not normalised. A line
+ * heads the same way at both, an arc leaves along one axis and arrives along
+ * the other. Zero for a piece of an arc that does not step along that axis.
+ * @param seg Segment
+ * @param end The end (true) or the start (false)
+ * @param x   Set to the x part
+ * @param y   Set to the y part
+ */
+void Planner::heading(Segment *seg, bool end, int &x, int &y) {
+    x = seg->dx * seg->xDir;
+    y = seg->dy * seg->yDir;
+
+    if(seg->kind == SEGMENT_LINE) return;
+
+    // Leaving along x (or arriving along x), drop the y part
+    if(((seg->kind & SEGMENT_ARC_X) != 0) != end) y = 0;
+    else x = 0;
+};
+
+/**
+ * Plan the entry speeds of every queued segment, call after each push().
+ * Segments the interrupt has started (or is about to) are left alone.
+ * @param queue Segment queue
+ */
+void Planner::plan(SegmentQueue *queue) {
+
+    unsigned long v2[SEGMENT_QUEUE_SIZE]; // Planned entry speed^2
+
+    while(true) {
+
+        // Snapshot where the interrupt is
+        noInterrupts();
+        Segment *tail = queue->tail();
+        bool busy = tail->busy;
+        uint8_t count = queue->size();
+        interrupts();
+
+        // The tail's entry is fixed (being stepped, or starting from rest).
+        // Once the tail is started its exit, the next entry, is fixed too.
+        uint8_t fixed = busy ? 1 : 0;
+        if(count <= fixed + 1) return;
+
+        // Reverse pass: every segment must be able to slow down in time for
+        // the next, and the last one for a stop
+        Segment *last = queue->get(count - 1);
+        unsigned long exit = (unsigned long)last->profile.start * last->profile.start;
+
+        for(uint8_t i=count-1; i>fixed; i--) {
+            Segment *seg = queue->get(i);
+            unsigned long max2 = (unsigned long)seg->maxEntry * seg->maxEntry;
+            v2[i] = min(max2, reach(exit, seg));
+            exit = v2[i];
+        }
+
+        // Forward pass: every segment must be reachable from the one before
+        Segment *prev = queue->get(fixed);
+        unsigned long entry = (unsigned long)prev->entry * prev->entry;
+
+        for(uint8_t i=fixed+1; i<count; i++) {
+            v2[i] = min(v2[i], reach(entry, prev));
+            entry = v2[i];
+            prev = queue->get(i);
+        }
+
+        // Square roots are slow, do them before stopping the interrupt
+        for(uint8_t i=fixed+1; i<count; i++) {
+            v2[i] = Fixed::isqrt(v2[i]);
+        }
+
+        // Write back, unless the interrupt moved on while we were planning
+        noInterrupts();
+        bool moved = queue->tail() != tail || tail->busy != busy;
+        if(!moved) {
+            for(uint8_t i=fixed+1; i<count; i++) {
+                queue->get(i)->entry = v2[i];
+            }
+        }
+        interrupts();
+
+        if(!moved) return;
+    }
+};
+
+/**
+ * Speed^2 reached after accelerating over a segment
+ *   v^2 = v0^2 + 2 * a * length
+ * @param  v2  Speed^2 at the start
+ * @param  seg Segment to accelerate over
+ * @return     Speed^2 at the end
+ */
+unsigned long Planner::reach(unsigned long v2, Segment *seg) {
+    unsigned long gain = 2UL * seg->profile.accel;
+
+    // Saturate rather than overflow on long segments
+    if(seg->length > 0xFFFFFFFFUL / gain) return 0xFFFFFFFFUL;
+    gain *= seg->length;
+    if(v2 > 0xFFFFFFFFUL - gain) return 0xFFFFFFFFUL;
+
+    return v2 + gain;
+};
@@ -0,0 +1,74 @@
+/**
+ *  Planner.h
+ *
+ *  Look-ahead planner for the segment queue. Works out how fast each segment
+ *  may enter from the angle it makes with the segment before it, then plans
+ *  the entry speeds over the whole queue so the steppers only slow down for
+ *  sharp corners and for the end of the queue, not at every joint of a curve.
+ *
+ *  Junction speeds use the junction deviation model: the corner is treated as
+ *  a small arc that strays at most PLANNER_DEVIATION from the real corner, and
+ *  the speed is whatever keeps the acceleration around that arc in the limit.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef PLANNER_H
+#define PLANNER_H
+#include "POS.h"
+#include "SegmentQueue.h"
+#include "../lib/Fixed.h"
+
+// How far the steppers may stray from a corner (1 step, raw Fixed). Bigger
+// takes corners faster, 0 stops at every corner.
+#define PLANNER_DEVIATION FIXED_ONE
+
+/**
+ * Plans the entry speeds of the queued segments
+ */
+class Planner {
+private:
+    /**
+     * Speed^2 reached after accelerating over a segment
+     * @param  v2  Speed^2 at the start
+     * @param  seg Segment to accelerate over
+     * @return     Speed^2 at the end
+     */
+    unsigned long reach(unsigned long v2, Segment *seg);
+
+    /**
+     * Direction a segment heads in at one of its ends, not normalised. A
+     * line heads the same way at both, an arc leaves along one axis and
+     * arrives along the other. Zero for a piece of an arc that does not step
+     * along that axis.
+     * @param seg Segment
+     * @param end The end (true) or the start (false)
+     * @param x   Set to the x part
+     * @param y   Set to the y part
+     */
+    void heading(Segment *seg, bool end, int &x, int &y);
+
+public:
+    /**
+     * Planner()
+     */
+    Planner(){};
+
+    /**
+     * Fastest speed to go from one segment into the next
+     * @param  prev Segment before the junction
+     * @param  seg  Segment after the junction
+     * @return      Max entry speed of seg (steps/s)
+     */
+    unsigned int junction(Segment *prev, Segment *seg);
+
+    /**
+     * Plan the entry speeds of every queued segment, call after each push().
+     * Segments the interrupt has started (or is about to) are left alone.
+     * @param queue Segment queue
+     */
+    void plan(SegmentQueue *queue);
+};
+
+#endif
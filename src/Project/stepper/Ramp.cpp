@@ -0,0 +1,71 @@
+/**
+ *  Ramp.cpp
+ *
+ *  Trapezoidal speed ramp for a single move. Hands out the time to wait before
+ *  each step so the steppers accelerate from the entry speed, cruise, and
+ *  decelerate to the exit speed.
+ *
+ *  Uses the integer step delay recurrence from Atmel AVR446 (one division per
+ *  step, no sqrt) so it is cheap enough to run per step on the Arduino.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Ramp.h"
+
+/**
+ * Start a new move
+ * @param steps   Number of steps in the move
+ * @param profile Speed limits to ramp with
+ * @param entry   Speed at the start of the move (steps/s)
+ * @param exit    Speed at the end of the move (steps/s)
+ */
+void Ramp::begin(unsigned long steps, Profile profile, unsigned int entry, unsigned int exit) {
+
+    // Never go slower than the start speed or faster than the cruise speed
+    if(entry < profile.start) entry = profile.start;
+    if(exit < profile.start) exit = profile.start;
+    if(entry > profile.speed) entry = profile.speed;
+    if(exit > profile.speed) exit = profile.speed;
+
+    _left = steps;
+    _first = true;
+
+    // Delays are kept in 1/16 us so the recurrence does not lose precision
+    _c = 16000000UL / entry;
+    _cMin = 16000000UL / profile.speed;
+
+    // Accelerating from rest to v takes v^2 / 2a steps
+    _n = ((unsigned long)entry * entry) / (2UL * profile.accel);
+    _nExit = ((unsigned long)exit * exit) / (2UL * profile.accel);
+};
+
+/**
+ * Get the delay before the next step, call once per step
+ * @return Delay (us)
+ */
+unsigned long Ramp::next() {
+
+    // First step goes out at the entry speed
+    if(_first) {
+        _first = false;
+
+    // Not enough steps left to slow to the exit speed, decelerate
+    //   c(n-1) = c(n) + 2c(n) / (4n - 1)
+    } else if(_n > _nExit && _left <= _n - _nExit) {
+        _c += (2 * _c) / (4 * _n - 1);
+        _n--;
+
+    // Below the cruise speed, accelerate
+    //   c(n) = c(n-1) - 2c(n-1) / (4n + 1)
+    } else if(_c > _cMin) {
+        _n++;
+        _c -= (2 * _c) / (4 * _n + 1);
+        if(_c < _cMin) _c = _cMin;
+    }
+
+    if(_left > 0) _left--;
+
+    return _c >> 4;
+};
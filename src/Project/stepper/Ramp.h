@@ -0,0 +1,68 @@
+/**
+ *  Ramp.h
+ *
+ *  Trapezoidal speed ramp for a single move. Hands out the time to wait before
+ *  each step so the steppers accelerate from the entry speed, cruise, and
+ *  decelerate to the exit speed.
+ *
+ *  Uses the integer step delay recurrence from Atmel AVR446 (one division per
+ *  step, no sqrt) so it is cheap enough to run per step on the Arduino.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef RAMP_H
+#define RAMP_H
+#include "POS.h"
+
+/**
+ * Trapezoidal speed ramp over a number of steps
+ */
+class Ramp {
+private:
+    unsigned long _left  = 0; // Steps left in the move
+    unsigned long _n     = 0; // Steps it takes to accelerate to the current speed
+    unsigned long _nExit = 0; // Steps it takes to accelerate to the exit speed
+    unsigned long _c     = 0; // Current step delay (1/16 us)
+    unsigned long _cMin  = 0; // Step delay at cruise speed (1/16 us)
+    bool _first = true;       // First step of the move, use the entry speed
+
+public:
+    /**
+     * Ramp()
+     */
+    Ramp(){};
+
+    /**
+     * Start a new move
+     * @param steps   Number of steps in the move
+     * @param profile Speed limits to ramp with
+     * @param entry   Speed at the start of the move (steps/s)
+     * @param exit    Speed at the end of the move (steps/s)
+     */
+    void begin(unsigned long steps, Profile profile, unsigned int entry, unsigned int exit);
+
+    /**
+     * Start a new move that starts and stops at the profile's start speed
+     * @param steps   Number of steps in the move
+     * @param profile Speed limits to ramp with
+     */
+    void begin(unsigned long steps, Profile profile){
+        begin(steps, profile, profile.start, profile.start);
+    };
+
+    /**
+     * Get the delay before the next step, call once per step
+     * @return Delay (us)
+     */
+    unsigned long next();
+
+    /**
+     * Steps left in the move
+     * @return steps
+     */
+    unsigned long left(){ return _left; };
+};
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ *  SegmentQueue.cpp
+ *
+ *  Fixed size ring buffer of motion segments. The Drive adds segments from
+ *  lineTo() and moveTo(), the step timer interrupt takes them off and steps
+ *  them out.
+ *
+ *  Only the Drive writes the head and only the interrupt moves the tail, so no
+ *  locking is needed as long as each side sticks to its end.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include "SegmentQueue.h"
+
+/**
+ * Number of segments in the queue
+ * @return count
+ */
+uint8_t SegmentQueue::size() {
+    return (_head - _tail) & (SEGMENT_QUEUE_SIZE - 1);
+};
+
+/**
+ * Add the filled head() slot to the queue
+ */
+void SegmentQueue::push() {
+    _head = (_head + 1) & (SEGMENT_QUEUE_SIZE - 1);
+};
+
+/**
+ * Remove the oldest segment, once it has been stepped out
+ */
+void SegmentQueue::pop() {
+    if(empty()) return;
+    _tail = (_tail + 1) & (SEGMENT_QUEUE_SIZE - 1);
+};
+
+/**
+ * Drop every segment (call with interrupts off)
+ */
+void SegmentQueue::clear() {
+    _tail = _head;
+};
@@ -0,0 +1,123 @@
+/**
+ *  SegmentQueue.h
+ *
+ *  Fixed size ring buffer of motion segments. The Drive adds segments from
+ *  lineTo() and moveTo(), the step timer interrupt takes them off and steps
+ *  them out.
+ *
+ *  Only the Drive writes the head and only the interrupt moves the tail, so no
+ *  locking is needed as long as each side sticks to its end.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef SEGMENTQUEUE_H
+#define SEGMENTQUEUE_H
+#include <stdint.h>
+#include "POS.h"
+
+// Number of segments held in the queue (power of 2)
+#define SEGMENT_QUEUE_SIZE 16
+
+// Kinds of segment
+#define SEGMENT_LINE  0 // Straight line (Bresenham)
+#define SEGMENT_ARC_X 1 // Quarter ellipse leaving along x, arriving along y
+#define SEGMENT_ARC_Y 2 // Quarter ellipse leaving along y, arriving along x
+#define SEGMENT_MORE  4 // Flag, carries on the arc of the segment before
+
+/**
+ * A single move of the steppers, a straight line or a piece of a quarter
+ * ellipse
+ */
+struct Segment {
+    unsigned int id;       // Number of the segment (telemetry)
+    uint8_t kind;          // SEGMENT_LINE, SEGMENT_ARC_X or SEGMENT_ARC_Y (+ MORE)
+    int dx;                // Steps along x (line), semi-axis along x (arc)
+    int dy;                // Steps along y (line), semi-axis along y (arc)
+    int8_t xDir;           // 1=forward, -1=backward, 0=none
+    int8_t yDir;           // 1=forward, -1=backward, 0=none
+    bool up;               // Pen up (moveTo) or down (lineTo)
+    Profile profile;       // Speed limits for the segment
+    unsigned int length;   // Length of the move (steps)
+    unsigned int ticks;    // Timer ticks to step it out
+    unsigned int maxEntry; // Fastest entry the junction allows (steps/s)
+    unsigned int entry;    // Planned entry speed (steps/s)
+    volatile bool busy;    // Being stepped out, entry can no longer change
+};
+
+/**
+ * Ring buffer of segments waiting to be stepped out
+ */
+class SegmentQueue {
+private:
+    Segment _buffer[SEGMENT_QUEUE_SIZE]; // Segments
+    volatile uint8_t _head = 0;          // Next free slot (written by Drive)
+    volatile uint8_t _tail = 0;          // Oldest segment (read by interrupt)
+
+public:
+    /**
+     * SegmentQueue()
+     */
+    SegmentQueue(){};
+
+    /**
+     * Number of segments in the queue
+     * @return count
+     */
+    uint8_t size();
+
+    /**
+     * Nothing left to step out
+     * @return true/false
+     */
+    bool empty(){ return _head == _tail; };
+
+    /**
+     * No room for another segment
+     * @return true/false
+     */
+    bool full(){ return size() == SEGMENT_QUEUE_SIZE - 1; };
+
+    /**
+     * Slot for the next segment, fill it then call push()
+     * @return Segment to fill
+     */
+    Segment *head(){ return &_buffer[_head]; };
+
+    /**
+     * Add the filled head() slot to the queue
+     */
+    void push();
+
+    /**
+     * Oldest segment in the queue
+     * @return Segment
+     */
+    Segment *tail(){ return &_buffer[_tail]; };
+
+    /**
+     * Segment n places from the tail (0 is the tail)
+     * @param  n index from the tail, less than size()
+     * @return   Segment
+     */
+    Segment *get(uint8_t n){ return &_buffer[(_tail + n) & (SEGMENT_QUEUE_SIZE - 1)]; };
+
+    /**
+     * Newest segment in the queue (check empty() first)
+     * @return Segment
+     */
+    Segment *last(){ return &_buffer[(_head - 1) & (SEGMENT_QUEUE_SIZE - 1)]; };
+
+    /**
+     * Remove the oldest segment, once it has been stepped out
+     */
+    void pop();
+
+    /**
+     * Drop every segment (call with interrupts off)
+     */
+    void clear();
+};
+
+#endif
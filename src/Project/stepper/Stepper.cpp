@@ -6,31 +6,46 @@
  *  EasyDriver to control the stepper.
  *
  *  @author Drew Sommer
- *  @version 1.0.1
+ *  @version 1.0.2
  *  @license MIT (https://mit-license.org)
  */
 #include <Arduino.h>
 #include "Stepper.h"
 
+/**
+ * Default profile for a stepper. The old fixed step period (2 * del) is kept as
+ * the start speed, the stepper ramps up to 6x that. At least 1 step/s, the
+ * Ramp divides by the start speed.
+ * @param  del delay (ms)
+ * @return     Profile
+ */
+static Profile defaultProfile(int del) {
+    unsigned int start = del > 0 && del < 500 ? 500 / del : 1;
+    return { start, start * 6, start * 10 };
+}
+
 /**
  * Instantiate a new stepper with the PinMap
  * @param map the pins for the stepper to manage
+ * @param del delay (ms), sets the start speed of the default profile
  */
 Stepper::Stepper(PinMap map, int del) // TODO: remove AB
-    : _step(map.step), _dir(map.dir), _enable(map.enable), _flip(map.flip), _del(del) {}
+    : _profile(defaultProfile(del)), _step(map.step), _dir(map.dir),
+    _enable(map.enable), _flip(map.flip) {}
 
 /**
  * Instantiate a new stepper with the PinMap
  * @param map the pins for the stepper to manage
+ * @param del delay (ms), sets the start speed of the default profile
  * @param ms1 the microstepping pin 1
  * @param ms2 the microstepping pin 2
  */
 Stepper::Stepper(PinMap map, int del, int ms1, int ms2) // TODO: remove AB
-    : _ms(true), _step(map.step), _dir(map.dir), _enable(map.enable), _flip(map.flip), _del(del),
-    _ms1(ms1), _ms2(ms2){}
+    : _profile(defaultProfile(del)), _step(map.step), _dir(map.dir),
+    _enable(map.enable), _ms1(ms1), _ms2(ms2), _ms(true), _flip(map.flip) {}
 
 /**
- * Used to setup the Stepper (called within steup())
+ * Used to setup the Stepper (called within steup()). Starts disabled.
  */
 void Stepper::attach() {
 
@@ -41,50 +56,73 @@ void Stepper::attach() {
         pinMode(_ms1, OUTPUT);
         pinMode(_ms2, OUTPUT);
     }
+
+    // Put the pins in a known state so we only write them on change
+    digitalWrite(_dir, LOW);
+    _dirMode = false;
+    digitalWrite(_enable, HIGH);
+    _enableMode = true;
 }
 
 /**
- * Move's the stepper forward a step
- * @return the new currentPos
+ * Power the driver (enable LOW), stays on till disable()
  */
-int Stepper::forward() {
+void Stepper::enable() {
+    if(!_enableMode) return;
     digitalWrite(_enable, LOW);
     _enableMode = false;
-    if(_flip == 1) digitalWrite(_dir, HIGH);
-    else digitalWrite(_dir, LOW);
-    _dirMode = false;
+}
+
+/**
+ * Power down the driver (enable HIGH), the motor can be moved by hand
+ */
+void Stepper::disable() {
+    if(_enableMode) return;
+    digitalWrite(_enable, HIGH);
+    _enableMode = true;
+}
+
+/**
+ * Move's the stepper forward a step, the caller times the steps
+ * @return the new currentPos
+ */
+int Stepper::forward() {
+    enable();
+
+    // Only write dir when it changes
+    bool dir = _flip == 1;
+    if(_dirMode != dir) {
+        digitalWrite(_dir, dir ? HIGH : LOW);
+        _dirMode = dir;
+    }
 
     digitalWrite(_step, HIGH);
-    delay(_del);
+    delayMicroseconds(STEP_PULSE);
     digitalWrite(_step, LOW);
-    delay(_del);
     _currentPos++;
 
-    digitalWrite(_enable, HIGH);
-    _enableMode = true;
-
     return _currentPos;
 }
 
 /**
- * Move's the stepper backwards a step
+ * Move's the stepper backwards a step, the caller times the steps
  * @return the new currentPos
  */
 int Stepper::backward() {
-    digitalWrite(_enable, LOW);
-    _enableMode = false;
-    if(_flip == 1) digitalWrite(_dir, LOW);
-    else digitalWrite(_dir, HIGH);
-    _dirMode = true;
+    enable();
+
+    // Only write dir when it changes
+    bool dir = _flip != 1;
+    if(_dirMode != dir) {
+        digitalWrite(_dir, dir ? HIGH : LOW);
+        _dirMode = dir;
+    }
 
     digitalWrite(_step, HIGH);
-    delay(_del);
+    delayMicroseconds(STEP_PULSE);
     digitalWrite(_step, LOW);
-    delay(_del);
     _currentPos--;
 
-    digitalWrite(_enable, HIGH);
-    _enableMode = true;
     return _currentPos;
 }
 
@@ -13,13 +13,16 @@
 #define STEPPER_H
 #include "POS.h"
 
+// Width of the step pulse (us), the EasyDriver needs at least 1us
+#define STEP_PULSE 2
+
 /**
  * Stepper controller for the easy driver
  * @param map a PinMap of the pins for the stepper, check POS.h for structure
  */
 class Stepper {
-private:
-    int _del;                 // delay (ms)
+protected:
+    Profile _profile;         // speed limits (steps/s)
     int _currentPos  = 0;     // current pos
 
     int _step;                // step pin
@@ -45,29 +48,45 @@ public:
     /**
      * Instantiate a new stepper with the PinMap
      * @param map the pins for the stepper to manage
+     * @param del delay (ms), sets the start speed of the default profile
      */
     Stepper(PinMap map, int del);
 
     /**
      * Instantiate a new stepper with the PinMap
      * @param map the pins for the stepper to manage
+     * @param del delay (ms), sets the start speed of the default profile
      * @param ms1 the microstepping pin 1
      * @param ms2 the microstepping pin 2
      */
     Stepper(PinMap map, int del, int ms1, int ms2);
 
     /**
-     * Move's the stepper forwardx x number of steps
+     * Move's the stepper forward a step, the caller times the steps. Enables
+     * the driver if it is not already.
      * @return the new currentPos
      */
     int forward();
 
     /**
-     * Move's the stepper backwards x number of steps
+     * Move's the stepper backwards a step, the caller times the steps. Enables
+     * the driver if it is not already.
      * @return the new currentPos
      */
     int backward();
 
+    /**
+     * Set the speed limits of the stepper
+     * @param profile start speed, max speed and acceleration (steps/s)
+     */
+    void setProfile(Profile profile){ _profile = profile; };
+
+    /**
+     * Get the speed limits of the stepper
+     * @return Profile
+     */
+    Profile getProfile(){ return _profile; };
+
     /**
      * Sets the microstepping value
      * @param  num 1 = full step, 2 = 1/2 step, 4 = 1/4 step, 8 = 1/8 step
@@ -83,9 +102,25 @@ public:
     bool setPOS(int num);
 
     /**
-     * Used to setup the Stepper (called within steup())
+     * Used to setup the Stepper (called within steup()). Starts disabled.
      */
     void attach();
+
+    /**
+     * Power the driver (enable LOW), stays on till disable()
+     */
+    void enable();
+
+    /**
+     * Power down the driver (enable HIGH), the motor can be moved by hand
+     */
+    void disable();
+
+    /**
+     * Driver is powered
+     * @return true/false
+     */
+    bool enabled(){ return !_enableMode; };
 };
 
 #endif
@@ -0,0 +1,296 @@
+/**
+ *  ArcTest.cpp
+ *
+ *  Quarter ellipses against the analytic curve. stepper/Arc on its own, its
+ *  radius of curvature, and whole ellipses drawn by Drive::arcTo() on the
+ *  simulated Uno, flat and degenerate ones included. After every step the
+ *  pen is checked for how far it is from the ellipse. Rotated ellipses,
+ *  drawn as lines, are checked the same way against the rotated curve.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.2
+ *  @license MIT (https://mit-license.org)
+ */
+#include <math.h>
+#include "Check.h"
+#include "Plotter.h"
+#include "stepper/Arc.h"
+#include "stepper/Planner.h"
+#include "shapes/Ellipse.h"
+
+static Drive &drive = Plotter::drive;
+
+// Furthest a step may be from the ellipse (steps)
+#define ARC_ERROR 0.75
+
+// Furthest a step of a rotated ellipse may be from it (steps), over the
+// tolerance: the centre and the points rounded to a step (half a step on
+// each axis, each) and the half step a line strays from its chord
+#define ROTATED_ERROR (2 * M_SQRT1_2 + 0.5)
+
+/**
+ * Distance from a point to an axis-aligned ellipse centred on the origin
+ * @param  a Semi-axis along x
+ * @param  b Semi-axis along y
+ * @param  x Point
+ * @param  y Point
+ * @return   Distance
+ */
+static double distance(double a, double b, double x, double y) {
+
+    // Only the quarter the point is in can be closest
+    PlotterCurve quarter = [a, b](double t, double &u, double &v) {
+        u = a * cos(M_PI / 2 * t);
+        v = b * sin(M_PI / 2 * t);
+    };
+    return Plotter::distance(quarter, 4 * (int)(a + b) + 64, fabs(x), fabs(y));
+};
+
+/**
+ * Step out a quarter with Arc, from (-a, 0) to (0, b), checking every point
+ * @param a Semi-axis along u
+ * @param b Semi-axis along v
+ */
+static void quarter(unsigned int a, unsigned int b) {
+    Arc arc;
+    arc.begin(a, b);
+
+    long u = -(long)a;
+    long v = 0;
+    unsigned int steps = 0;
+    double worst = 0;
+    uint8_t step;
+
+    while((step = arc.next()) != 0 && steps <= a + b) {
+        if(step & ARC_U) u++;
+        if(step & ARC_V) v++;
+        steps++;
+
+        double error = distance(a, b, u, v);
+        if(error > worst) worst = error;
+    }
+
+    printf("  quarter %u x %u: %u steps, worst %.3f steps off\n", a, b, steps, worst);
+
+    CHECK(u == 0 && v == b);
+    CHECK(steps <= a + b);
+    CHECK(steps >= (a > b ? a : b));
+    CHECK(worst <= ARC_ERROR);
+};
+
+/**
+ * Radius of curvature against the exact one, along a quarter. The integer
+ * divides round it down, which only slows a bend, it is never over.
+ *   r = (a^4 v^2 + b^4 u^2)^(3/2) / (a^4 b^4)
+ * @param a Semi-axis along u
+ * @param b Semi-axis along v
+ */
+static void radius(unsigned int a, unsigned int b) {
+    bool over = false;
+    double worst = 0;
+
+    for(int i = 0; i <= 16; i++) {
+        double t = M_PI / 2 * i / 16;
+        unsigned int u = (unsigned int)lround(a * cos(t));
+        unsigned int v = (unsigned int)lround(b * sin(t));
+
+        double a4 = pow(a, 4);
+        double b4 = pow(b, 4);
+        double exact = pow(a4 * v * v + b4 * u * u, 1.5) / (a4 * b4);
+        if(exact > 65535) exact = 65535;
+
+        double r = Arc::radius(a, b, u, v);
+        if(r > exact + 1e-9) over = true;
+
+        // Under by up to 15%, and 2 steps for the truncated parts
+        double under = (exact - r - 2) / exact;
+        if(under > worst) worst = under;
+    }
+
+    printf("  radius %u x %u: %.1f%% under past 2 steps\n", a, b, worst * 100);
+    CHECK(!over);
+    CHECK(worst <= 0.15);
+};
+
+/**
+ * Draw a whole ellipse with arcTo(), as an unrotated Ellipse does, and check
+ * every step against it
+ * @param a Semi-axis along x
+ * @param b Semi-axis along y
+ */
+static void ellipse(int a, int b) {
+    POS c = { 500, 500 };
+
+    drive.moveTo(c.x - a, c.y);
+    drive.sync();
+    Sim::steps().clear();
+
+    drive.arcTo(c.x, c.y + b, false);
+    drive.arcTo(c.x + a, c.y, true);
+    drive.arcTo(c.x, c.y - b, false);
+    drive.arcTo(c.x - a, c.y, true);
+    drive.sync();
+
+    // Replay the steps, checking each tick against the ellipse
+    std::vector<PlotterTick> ticks = Plotter::ticks(-a, 0);
+    long x = -a;
+    long y = 0;
+    double worst = 0;
+    double fastest = 0;
+    unsigned long last = 0;
+
+    for(size_t i = 0; i < ticks.size(); i++) {
+        x = ticks[i].x;
+        y = ticks[i].y;
+
+        double error = distance(a, b, x, y);
+        if(error > worst) worst = error;
+
+        if(last != 0 && 1e6 / (ticks[i].us - last) > fastest) fastest = 1e6 / (ticks[i].us - last);
+        last = ticks[i].us;
+    }
+
+    printf("  ellipse %d x %d: %u steps, worst %.3f steps off, up to %.0f steps/s\n",
+        a, b, (unsigned int)Sim::steps().size(), worst, fastest);
+
+    CHECK(x == -a && y == 0);
+    CHECK(drive.get().x == c.x - a && drive.get().y == c.y);
+    CHECK(Plotter::position().x == c.x - a && Plotter::position().y == c.y);
+    CHECK(worst <= ARC_ERROR);
+    CHECK(fastest <= Plotter::feed.speed * 1.01);
+};
+
+/**
+ * Draw a rotated Ellipse and check every step against the rotated curve.
+ * Its centre is moved as Ellipse has it, by the shift from the centre to
+ * the origin rotated.
+ * @param cx     Centre x
+ * @param cy     Centre y
+ * @param a      Semi-axis along x before rotating
+ * @param b      Semi-axis along y before rotating
+ * @param origin Origin to rotate by
+ * @param angle  Angle (degrees)
+ */
+static void rotated(int cx, int cy, int a, int b, POS origin, int angle) {
+    double tolerance = SHAPE_TOLERANCE / (double)FIXED_ONE;
+    double t = angle * M_PI / 180;
+    double sx = origin.x - cx;
+    double sy = origin.y - cy;
+    double x0 = cx - lround(cos(t) * sx - sin(t) * sy);
+    double y0 = cy - lround(sin(t) * sx + cos(t) * sy);
+
+    PlotterCurve exact = [=](double u, double &x, double &y) {
+        double ex = a * cos(2 * M_PI * u);
+        double ey = b * sin(2 * M_PI * u);
+        x = x0 + cos(t) * ex - sin(t) * ey;
+        y = y0 + sin(t) * ex + cos(t) * ey;
+    };
+
+    // Draw it from where it starts, so only the curve is stepped
+    POS start = { (int)lround(x0 - cos(t) * a), (int)lround(y0 - sin(t) * a) };
+    drive.moveTo(start.x, start.y);
+    drive.sync();
+    POS from = Plotter::position();
+    Sim::steps().clear();
+
+    Ellipse(cx, cy, a, b, origin, angle).draw(false);
+    drive.sync();
+
+    int n = 4 * (abs(a) + abs(b)) + 256;
+    std::vector<PlotterTick> ticks = Plotter::ticks(from.x, from.y);
+    double worst = 0;
+
+    for(size_t i = 0; i < ticks.size(); i++) {
+        double error = Plotter::distance(exact, n, ticks[i].x, ticks[i].y);
+        if(error > worst) worst = error;
+    }
+
+    printf("  rotated %d x %d by %d about (%d,%d): %u steps, worst %.3f steps off\n",
+        a, b, angle, origin.x, origin.y, (unsigned int)Sim::steps().size(), worst);
+
+    // Closed, back where it started
+    POS end = Plotter::position();
+    CHECK(drive.get().x == end.x && drive.get().y == end.y);
+    CHECK(abs(end.x - from.x) <= 1 && abs(end.y - from.y) <= 1);
+    CHECK(worst <= tolerance + ROTATED_ERROR);
+};
+
+/**
+ * A junction next to a piece of an arc with no heading (it only steps along
+ * the axis it does not arrive on) stops, it does not divide by zero
+ */
+static void heading() {
+    Planner planner;
+    Profile feed = Plotter::feed;
+
+    // Last piece of a quarter 1 wide and 150 high leaving along y, it
+    // arrives along x but the piece only steps y
+    Segment prev = {};
+    prev.kind = SEGMENT_ARC_Y | SEGMENT_MORE;
+    prev.dx = 1;
+    prev.dy = 150;
+    prev.xDir = 0;
+    prev.yDir = 1;
+    prev.profile = feed;
+
+    // Line on along x
+    Segment seg = {};
+    seg.kind = SEGMENT_LINE;
+    seg.dx = 100;
+    seg.dy = 0;
+    seg.xDir = 1;
+    seg.yDir = 0;
+    seg.profile = feed;
+
+    CHECK(planner.junction(&prev, &seg) == feed.start);
+
+    // And the first piece of one that leaves along y without stepping it
+    Segment next = {};
+    next.kind = SEGMENT_ARC_Y;
+    next.dx = 150;
+    next.dy = 1;
+    next.xDir = 1;
+    next.yDir = 0;
+    next.profile = feed;
+
+    CHECK(planner.junction(&seg, &next) == feed.start);
+};
+
+int main() {
+    Plotter::attach();
+
+    // Circles, ellipses either way round, flat and degenerate ones
+    unsigned int sizes[][2] = {
+        { 1, 1 }, { 2, 1 }, { 1, 2 }, { 10, 10 }, { 100, 100 }, { 200, 50 },
+        { 50, 200 }, { 1, 150 }, { 150, 1 }, { 3, 400 }, { 1000, 999 },
+        { 2000, 700 }
+    };
+    for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        quarter(sizes[i][0], sizes[i][1]);
+        radius(sizes[i][0], sizes[i][1]);
+    }
+
+    ellipse(100, 100);
+    ellipse(300, 80);
+    ellipse(80, 300);
+    ellipse(1, 150);
+    ellipse(150, 1);
+    ellipse(2, 2);
+    ellipse(0, 100);
+
+    // Rotated, about the centre and off it, negative, degenerate and large
+    rotated(500, 500, 300, 100, { 500, 500 }, 30);
+    rotated(500, 500, 100, 300, { 500, 500 }, -45);
+    rotated(500, 500, 200, 200, { 500, 500 }, 90);
+    rotated(400, 300, 250, 60, { 100, 100 }, 135);
+    rotated(500, 500, -200, 80, { 500, 500 }, 20);
+    rotated(500, 500, -120, -90, { 500, 500 }, 75);
+    rotated(500, 500, 150, 0, { 500, 500 }, 60);
+    rotated(500, 500, 0, 0, { 500, 500 }, 10);
+    rotated(500, 500, 1, 2, { 500, 500 }, 45);
+    rotated(2500, 2500, 2000, -1500, { 2500, 2500 }, 1);
+
+    heading();
+
+    return Check::done("ArcTest");
+};
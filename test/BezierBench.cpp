@@ -0,0 +1,298 @@
+/**
+ *  BezierBench.cpp
+ *
+ *  Time to work out the points of a Bezier curve, the three ways draw() has
+ *  done it, on the host (make bench):
+ *
+ *    pow       the first: the cubic in double with pow(), a point per step
+ *              along x
+ *    forward   forward differences at t = i / 2^k, 64 bit adds, the
+ *              first's resolution rounded up (drawn for a while, then
+ *              replaced by split)
+ *    split     the curve split in half (de Casteljau) until each piece is
+ *              within SHAPE_TOLERANCE of a line, as shapes/Bezier.cpp does
+ *
+ *  The points go to a sink here, not to the Drive, so it is their cost
+ *  alone. Each one is a line the Drive plans and queues (which costs far
+ *  more than working it out), so the lines per curve are printed too. As
+ *  with FixedBench these are host nanoseconds, not Uno cycles: on the AVR
+ *  double is a software routine, pow() most of all, and 64 bit adds take
+ *  several instructions each. BezierTest checks the points split draws.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <stdint.h>
+#include "lib/Fixed.h"
+#include "shapes/Bezier.h"
+
+// Curves timed per size, and times each is worked out
+#define BENCH_CURVES 100
+#define BENCH_RUNS 20
+
+// Most points forward differences took, 2^BENCH_FORWARD
+#define BENCH_FORWARD 12
+
+// Points are summed into this so the work is not thrown away
+static volatile long sink;
+
+/**
+ * Where the points go, a line to each unless it is where the last one was
+ * (as the Drive skips those)
+ */
+struct Sink {
+    long x;              // Last point
+    long y;              // Last point
+    long sum;            // Points summed
+    unsigned long lines; // Lines to them
+
+    /**
+     * A point, a line to it
+     * @param px Point
+     * @param py Point
+     */
+    void to(long px, long py) {
+        if(px == x && py == y) return;
+        x = px;
+        y = py;
+        sum += px + py;
+        lines++;
+    };
+};
+
+/**
+ * Nanoseconds now
+ * @return ns
+ */
+static double now() {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+};
+
+/**
+ * The first draw(): the cubic in double with pow(), a point for every step
+ * the control polygon takes along x
+ * @param p   Control points
+ * @param out Sink
+ */
+static void byPow(const POS *p, Sink &out) {
+    int resolution = abs(p[1].x - p[0].x) + abs(p[2].x - p[1].x) + abs(p[3].x - p[2].x);
+
+    for(int i = 0; i <= resolution; i++) {
+        double t = (double)i / (double)resolution;
+        double t2 = pow(t, 2);
+        double t3 = pow(t, 3);
+
+        int x = (int)(p[0].x + 3 * t * (p[1].x - p[0].x) + 3 * t2 * (p[0].x + p[2].x - 2 * p[1].x) +
+            t3 * (p[3].x - p[0].x + 3 * p[1].x - 3 * p[2].x));
+        int y = (int)(p[0].y + 3 * t * (p[1].y - p[0].y) + 3 * t2 * (p[0].y + p[2].y - 2 * p[1].y) +
+            t3 * (p[3].y - p[0].y + 3 * p[1].y - 3 * p[2].y));
+
+        out.to(x, y);
+    }
+};
+
+/**
+ * One axis stepped by forward differences, scaled by 2^3k
+ */
+struct Axis {
+    int64_t p;  // Value
+    int64_t d1; // First difference
+    int64_t d2; // Second difference
+    int64_t d3; // Third difference (constant)
+};
+
+/**
+ * Start stepping one axis by forward differences at t = i / 2^k
+ * @param  p0 Start
+ * @param  p1 First control point
+ * @param  p2 Second control point
+ * @param  p3 End
+ * @param  k  2^k points
+ * @return    Axis at t = 0
+ */
+static Axis axis(int p0, int p1, int p2, int p3, uint8_t k) {
+    int64_t a = (int64_t)p3 - p0 + 3L * p1 - 3L * p2;
+    int64_t b = 3L * (p0 + p2 - 2L * p1);
+    int64_t c = 3L * (p1 - p0);
+    int64_t n = (int64_t)1 << k;
+
+    Axis axis;
+    axis.p = p0 * n * n * n;
+    axis.d1 = a + b * n + c * n * n;
+    axis.d2 = 6 * a + 2 * b * n;
+    axis.d3 = 6 * a;
+    return axis;
+};
+
+/**
+ * Forward differences, at the first draw()'s resolution rounded up to a
+ * power of two (at most 2^BENCH_FORWARD points)
+ * @param p   Control points
+ * @param out Sink
+ */
+static void byForward(const POS *p, Sink &out) {
+    int resolution = abs(p[1].x - p[0].x) + abs(p[2].x - p[1].x) + abs(p[3].x - p[2].x);
+
+    uint8_t k = 0;
+    while((1 << k) < resolution && k < BENCH_FORWARD) k++;
+
+    Axis x = axis(p[0].x, p[1].x, p[2].x, p[3].x, k);
+    Axis y = axis(p[0].y, p[1].y, p[2].y, p[3].y, k);
+    int64_t half = k > 0 ? (int64_t)1 << (3 * k - 1) : 0;
+
+    for(int i = 1; i <= (1 << k); i++) {
+        x.p += x.d1; x.d1 += x.d2; x.d2 += x.d3;
+        y.p += y.d1; y.d1 += y.d2; y.d2 += y.d3;
+        out.to((x.p + half) >> (3 * k), (y.p + half) >> (3 * k));
+    }
+};
+
+/**
+ * Control points of (part of) a curve, in 1/BEZIER_ONE steps
+ */
+struct Curve {
+    long x[4]; // x of p0 to p3
+    long y[4]; // y of p0 to p3
+};
+
+/**
+ * Second half of a split curve, waiting its turn
+ */
+struct Half {
+    long x[3];     // x of p1 to p3
+    long y[3];     // y of p1 to p3
+    uint8_t depth; // Times split
+};
+
+/**
+ * The curve is within the tolerance of the line between its ends, as
+ * Bezier::flat()
+ * @param  c Curve
+ * @return   true/false
+ */
+static bool flat(const Curve &c) {
+    unsigned long ux = labs(3 * c.x[1] - 2 * c.x[0] - c.x[3]);
+    unsigned long uy = labs(3 * c.y[1] - 2 * c.y[0] - c.y[3]);
+    unsigned long vx = labs(3 * c.x[2] - c.x[0] - 2 * c.x[3]);
+    unsigned long vy = labs(3 * c.y[2] - c.y[0] - 2 * c.y[3]);
+    unsigned long mx = max(ux, vx);
+    unsigned long my = max(uy, vy);
+
+    unsigned long limit = Fixed::scale(4 * BEZIER_ONE, Fixed::fromRaw(SHAPE_TOLERANCE));
+    if(limit > 32767) limit = 32767;
+
+    if(mx > limit || my > limit) return false;
+    return mx * mx + my * my <= limit * limit;
+};
+
+/**
+ * Split a curve in half at t = 1/2, as Bezier::split()
+ * @param c     Curve, replaced by its first half
+ * @param right Set to the second half
+ */
+static void split(Curve &c, Half &right) {
+    long *p[2] = { c.x, c.y };
+    long *r[2] = { right.x, right.y };
+
+    for(uint8_t i = 0; i < 2; i++) {
+        long p01 = (p[i][0] + p[i][1]) / 2;
+        long p12 = (p[i][1] + p[i][2]) / 2;
+        long p23 = (p[i][2] + p[i][3]) / 2;
+        long p012 = (p01 + p12) / 2;
+        long p123 = (p12 + p23) / 2;
+
+        r[i][0] = p123;
+        r[i][1] = p23;
+        r[i][2] = p[i][3];
+        p[i][1] = p01;
+        p[i][2] = p012;
+        p[i][3] = (p012 + p123) / 2;
+    }
+};
+
+/**
+ * Split until flat, as Bezier::draw()
+ * @param p   Control points
+ * @param out Sink
+ */
+static void bySplit(const POS *p, Sink &out) {
+    Curve c = {
+        { p[0].x * BEZIER_ONE, p[1].x * BEZIER_ONE, p[2].x * BEZIER_ONE, p[3].x * BEZIER_ONE },
+        { p[0].y * BEZIER_ONE, p[1].y * BEZIER_ONE, p[2].y * BEZIER_ONE, p[3].y * BEZIER_ONE }
+    };
+    Half stack[BEZIER_DEPTH];
+    uint8_t top = 0;
+    uint8_t depth = 0;
+
+    for(;;) {
+        if(depth < BEZIER_DEPTH && !flat(c)) {
+            split(c, stack[top]);
+            stack[top++].depth = ++depth;
+            continue;
+        }
+
+        out.to((c.x[3] + BEZIER_ONE / 2) >> BEZIER_SHIFT, (c.y[3] + BEZIER_ONE / 2) >> BEZIER_SHIFT);
+        if(top == 0) break;
+
+        Half &h = stack[--top];
+        c.x[0] = c.x[3];
+        c.y[0] = c.y[3];
+        for(uint8_t i = 0; i < 3; i++) {
+            c.x[i + 1] = h.x[i];
+            c.y[i + 1] = h.y[i];
+        }
+        depth = h.depth;
+    }
+};
+
+/**
+ * Time a way of working out the points over a set of curves
+ * @param name   Way
+ * @param points Works out the points of a curve
+ * @param curves Control points, 4 a curve
+ * @param n      Curves
+ */
+static void bench(const char *name, void (*points)(const POS *, Sink &), const POS *curves, int n) {
+    Sink out = {};
+
+    double start = now();
+    for(int run = 0; run < BENCH_RUNS; run++) {
+        for(int i = 0; i < n; i++) {
+            out.x = curves[4 * i].x;
+            out.y = curves[4 * i].y;
+            points(&curves[4 * i], out);
+        }
+    }
+    double ns = (now() - start) / BENCH_RUNS / n;
+
+    sink = out.sum;
+    printf("  %-8s %9.0f ns %6.0f lines\n", name, ns, (double)out.lines / BENCH_RUNS / n);
+};
+
+int main() {
+    static POS curves[4 * BENCH_CURVES];
+
+    printf("BezierBench: host ns and lines per curve (not AVR cycles)\n");
+
+    srand(15);
+    for(int size = 10; size <= 10000; size *= 10) {
+        for(int i = 0; i < 4 * BENCH_CURVES; i++) {
+            curves[i].x = rand() % (2 * size + 1) - size;
+            curves[i].y = rand() % (2 * size + 1) - size;
+        }
+
+        printf(" %d curves %d steps across\n", BENCH_CURVES, 2 * size);
+        bench("pow", byPow, curves, BENCH_CURVES);
+        bench("forward", byForward, curves, BENCH_CURVES);
+        bench("split", bySplit, curves, BENCH_CURVES);
+    }
+
+    return 0;
+};
@@ -0,0 +1,155 @@
+/**
+ *  BezierTest.cpp
+ *
+ *  Bezier curves drawn on the simulated Uno against the exact cubic. Every
+ *  step is within the chord tolerance of the curve, plus the ends of each
+ *  line being rounded to a step (half a step on each axis) and the half step
+ *  a line strays from its chord. The curve ends exactly on p3. Degenerate
+ *  curves (a point, straight, vertical) and sharp ones (a cusp, a loop) are
+ *  drawn as well as random ones.
+ *
+ *  For each batch of curves the time the plotter takes to draw them is
+ *  printed, it is not checked.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#include <math.h>
+#include "Check.h"
+#include "Plotter.h"
+#include "shapes/Bezier.h"
+
+static Drive &drive = Plotter::drive;
+
+// Furthest a step may be from the curve (steps), over the tolerance
+#define BEZIER_ERROR (M_SQRT1_2 + 0.5)
+
+/**
+ * Point on the curve
+ * @param p  Control points
+ * @param t  0 to 1
+ * @param x  Set to x
+ * @param y  Set to y
+ */
+static void point(const POS *p, double t, double &x, double &y) {
+    double s = 1 - t;
+    double a = s * s * s;
+    double b = 3 * s * s * t;
+    double c = 3 * s * t * t;
+    double d = t * t * t;
+    x = a * p[0].x + b * p[1].x + c * p[2].x + d * p[3].x;
+    y = a * p[0].y + b * p[1].y + c * p[2].y + d * p[3].y;
+};
+
+/**
+ * Draw a curve and follow the steps, checking each point against it
+ * @param  p     Control points
+ * @param  print Print the result
+ * @return       Worst distance from the curve (steps)
+ */
+static double curve(const POS *p, bool print) {
+
+    drive.moveTo(p[0].x, p[0].y);
+    drive.sync();
+    Sim::steps().clear();
+
+    Bezier(p[0], p[1], p[2], p[3]).draw();
+    drive.sync();
+
+    // Replay the steps, checking each tick against the curve
+    PlotterCurve exact = [p](double t, double &x, double &y) { point(p, t, x, y); };
+    std::vector<PlotterTick> ticks = Plotter::ticks(p[0].x, p[0].y);
+    long x = p[0].x;
+    long y = p[0].y;
+    double worst = Plotter::distance(exact, 4096, x, y);
+
+    for(size_t i = 0; i < ticks.size(); i++) {
+        x = ticks[i].x;
+        y = ticks[i].y;
+
+        double error = Plotter::distance(exact, 4096, x, y);
+        if(error > worst) worst = error;
+    }
+
+    if(print) {
+        printf("  (%d,%d) (%d,%d) (%d,%d) (%d,%d): %u steps, worst %.3f steps off\n",
+            p[0].x, p[0].y, p[1].x, p[1].y, p[2].x, p[2].y, p[3].x, p[3].y,
+            (unsigned int)Sim::steps().size(), worst);
+    }
+
+    CHECK(x == p[3].x && y == p[3].y);
+    CHECK(Plotter::position().x == p[3].x && Plotter::position().y == p[3].y);
+
+    return worst;
+};
+
+/**
+ * Random curves, from short to a thousand steps across
+ */
+static void randoms() {
+    double tolerance = SHAPE_TOLERANCE / (double)FIXED_ONE;
+    double worst = 0;
+
+    srand(5);
+    for(int size = 10; size <= 1000; size *= 10) {
+        unsigned long from = Sim::now();
+
+        for(int i = 0; i < 10; i++) {
+            POS p[4];
+            for(int j = 0; j < 4; j++) {
+                p[j].x = rand() % (2 * size + 1) - size;
+                p[j].y = rand() % (2 * size + 1) - size;
+            }
+
+            double error = curve(p, false);
+            if(error > worst) worst = error;
+        }
+
+        printf("  10 curves %d steps across: %.1fs to plot\n", 2 * size, (Sim::now() - from) / 1e6);
+    }
+
+    printf("  random: worst %.3f steps off\n", worst);
+    CHECK(worst <= tolerance + BEZIER_ERROR);
+};
+
+/**
+ * Curves that are not really curves, double back or turn sharply: a point,
+ * straight ones, vertical and horizontal ones, a cusp and a loop
+ */
+static void shapes() {
+    double tolerance = SHAPE_TOLERANCE / (double)FIXED_ONE;
+    POS curves[][4] = {
+        { { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 } },            // Point
+        { { 0, 0 }, { 100, 50 }, { 200, 100 }, { 300, 150 } }, // Straight
+        { { 0, 0 }, { 0, 0 }, { 300, 150 }, { 300, 150 } },    // Straight, bunched
+        { { 0, 0 }, { 0, 100 }, { 0, 200 }, { 0, 300 } },      // Vertical
+        { { 0, 0 }, { 0, 400 }, { 0, -400 }, { 0, 0 } },       // Vertical, back
+        { { 0, 0 }, { 400, 0 }, { -100, 0 }, { 300, 0 } },     // Horizontal, back
+        { { 0, 0 }, { 300, 300 }, { 0, 300 }, { 300, 0 } },    // Cusp
+        { { 0, 0 }, { 400, 300 }, { -100, 300 }, { 300, 0 } }, // Loop
+        { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 1, 0 } }             // Tiny
+    };
+
+    for(size_t i = 0; i < sizeof(curves) / sizeof(curves[0]); i++) {
+        double error = curve(curves[i], true);
+        CHECK(error <= tolerance + BEZIER_ERROR);
+    }
+
+    // A point takes no steps, a straight curve is one line
+    curve(curves[0], false);
+    CHECK(Sim::steps().empty());
+    curve(curves[1], false);
+    CHECK(Sim::steps().size() == 450);
+    curve(curves[3], false);
+    CHECK(Plotter::steps(PLOTTER_X) == 0 && Plotter::steps(PLOTTER_Y) == 300);
+};
+
+int main() {
+    Plotter::attach();
+
+    shapes();
+    randoms();
+
+    return Check::done("BezierTest");
+};
@@ -0,0 +1,154 @@
+/**
+ *  DriveTest.cpp
+ *
+ *  Moves are queued and stepped out by Drive::tick() from the Timer2
+ *  interrupt: lineTo() returns straight away, the steps come from the
+ *  timer, and the steppers end up where the moves said. A move waiting on
+ *  room in the queue runs the wait hook while it waits.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Check.h"
+#include "Plotter.h"
+
+static Drive &drive = Plotter::drive;
+
+/**
+ * Shortest time between steps of an axis in the log
+ * @param  axis Axis
+ * @return      Time (us)
+ */
+static unsigned long shortest(uint8_t axis) {
+    unsigned long best = (unsigned long)-1;
+    unsigned long last = 0;
+    bool first = true;
+
+    for(size_t i = 0; i < Sim::steps().size(); i++) {
+        const SimStep &s = Sim::steps()[i];
+        if(s.axis != axis) continue;
+        if(!first && s.us - last < best) best = s.us - last;
+        last = s.us;
+        first = false;
+    }
+    return best;
+};
+
+/**
+ * A line is queued, not drawn, and is stepped out by the timer
+ */
+static void queued() {
+    Sim::steps().clear();
+    unsigned long start = Sim::now();
+
+    drive.lineTo(200, 100);
+
+    // Back before the pen is down, let alone the line drawn
+    CHECK(Sim::now() - start < 5000);
+    CHECK(drive.busy());
+    CHECK(Sim::steps().size() == 0);
+
+    // The timer steps it out while we do nothing
+    Sim::run(3000000);
+    CHECK(!drive.busy());
+    CHECK(Plotter::position().x == 200);
+    CHECK(Plotter::position().y == 100);
+    CHECK(Plotter::steps(PLOTTER_X) == 200);
+    CHECK(Plotter::steps(PLOTTER_Y) == 100);
+};
+
+/**
+ * More moves than the queue holds, lineTo() waits for room and sync() for
+ * the lot. Both axes go back and forth, every step is accounted for.
+ */
+static void square() {
+    Sim::steps().clear();
+    POS start = Plotter::position();
+
+    for(int i = 0; i < 10; i++) {
+        drive.lineTo(start.x + 150, start.y);
+        drive.lineTo(start.x + 150, start.y - 150);
+        drive.lineTo(start.x, start.y - 150);
+        drive.lineTo(start.x, start.y);
+    }
+    drive.sync();
+
+    CHECK(!drive.busy());
+    CHECK(Plotter::position().x == start.x);
+    CHECK(Plotter::position().y == start.y);
+    CHECK(Plotter::steps(PLOTTER_X) == 10 * 300);
+    CHECK(Plotter::steps(PLOTTER_Y) == 10 * 300);
+    CHECK(drive.get().x == start.x && drive.get().y == start.y);
+
+    // Never faster than the cruise speed, the timer is 2us a tick
+    CHECK(shortest(PLOTTER_X) + 2 >= 1000000UL / Plotter::feed.speed);
+    CHECK(shortest(PLOTTER_Y) + 2 >= 1000000UL / Plotter::feed.speed);
+};
+
+/**
+ * A move with the pen up lifts it, a line waits for the pen to get down
+ * before the first step
+ */
+static void pen() {
+    drive.moveTo(0, 0);
+    drive.sync();
+    CHECK(Sim::servo() == 0);
+    CHECK(Plotter::position().x == 0 && Plotter::position().y == 0);
+
+    Sim::steps().clear();
+    drive.lineTo(50, 50);
+    drive.sync();
+
+    CHECK(Sim::servo() == 71);
+    CHECK(Sim::steps().size() == 100);
+    CHECK(Sim::steps()[0].us >= Sim::servoTime() + 71UL * 5 * 1000);
+};
+
+// Times the wait hook ran, and whether moves were being stepped out then
+static unsigned long waits = 0;
+static bool stepping = false;
+
+/**
+ * Wait hook, counts the waits
+ */
+static void waited() {
+    waits++;
+    stepping = drive.busy();
+};
+
+/**
+ * Moves that find the queue full wait for room running the wait hook, the
+ * ones that find room do not
+ */
+static void wait() {
+    drive.moveTo(0, 0);
+    drive.sync();
+    drive.setWait(waited);
+
+    // Fewer than the queue holds, no waiting
+    waits = 0;
+    for(int i = 1; i < SEGMENT_QUEUE_SIZE - 1; i++) drive.lineTo(i * 10, i % 2 * 10);
+    CHECK(waits == 0);
+
+    // One more fills it, the next waits on the first to be stepped out
+    drive.lineTo(SEGMENT_QUEUE_SIZE * 10, 0);
+    drive.lineTo(SEGMENT_QUEUE_SIZE * 10 + 10, 10);
+    CHECK(waits > 0);
+    CHECK(stepping);
+    drive.sync();
+
+    CHECK(Plotter::position().x == SEGMENT_QUEUE_SIZE * 10 + 10 && Plotter::position().y == 10);
+    drive.setWait(NULL);
+};
+
+int main() {
+    Plotter::attach();
+
+    queued();
+    square();
+    pen();
+    wait();
+
+    return Check::done("DriveTest");
+};
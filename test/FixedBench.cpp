@@ -0,0 +1,93 @@
+/**
+ *  FixedBench.cpp
+ *
+ *  Time of each lib/Fixed operation next to the same operation in float, on
+ *  the host (make bench). These are host nanoseconds, not Uno cycles: the
+ *  host has an FPU, so float comes out far cheaper here than on the AVR,
+ *  where it is a software routine. What carries over is the cost of the
+ *  Fixed operations against each other (a multiply against a divide, a
+ *  sqrt or a sin). Counting AVR cycles takes avr-gcc and a simulator such
+ *  as simavr, which this build does not need.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include "lib/Fixed.h"
+
+// Operations timed per run
+#define BENCH_OPS 2000000
+
+// Inputs, cycled through so the compiler can not fold them
+#define BENCH_VALUES 256
+
+static Fixed fixeds[BENCH_VALUES];
+static float floats[BENCH_VALUES];
+
+// Results are summed into these so the work is not thrown away
+static volatile int32_t fixedSink;
+static volatile float floatSink;
+
+/**
+ * Nanoseconds now
+ * @return ns
+ */
+static double now() {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+};
+
+/**
+ * Time a Fixed and a float operation
+ * @param name  Operation
+ * @param fixed Fixed operation on two inputs
+ * @param real  Float operation on two inputs
+ */
+static void bench(const char *name, Fixed (*fixed)(Fixed, Fixed), float (*real)(float, float)) {
+    int32_t fs = 0;
+    float rs = 0;
+
+    double start = now();
+    for(long i = 0; i < BENCH_OPS; i++) {
+        fs += fixed(fixeds[i % BENCH_VALUES], fixeds[(i + 1) % BENCH_VALUES]).raw;
+    }
+    double fixedNs = (now() - start) / BENCH_OPS;
+
+    start = now();
+    for(long i = 0; i < BENCH_OPS; i++) {
+        rs += real(floats[i % BENCH_VALUES], floats[(i + 1) % BENCH_VALUES]);
+    }
+    double realNs = (now() - start) / BENCH_OPS;
+
+    fixedSink = fs;
+    floatSink = rs;
+    printf("  %-6s Fixed %6.2f ns   float %6.2f ns\n", name, fixedNs, realNs);
+};
+
+static Fixed fixedMul(Fixed a, Fixed b){ return a * b; };
+static Fixed fixedDiv(Fixed a, Fixed b){ return a / b; };
+static Fixed fixedSqrt(Fixed a, Fixed){ return Fixed::sqrt(a); };
+static Fixed fixedSin(Fixed a, Fixed){ return Fixed::sin(a); };
+static float floatMul(float a, float b){ return a * b; };
+static float floatDiv(float a, float b){ return a / b; };
+static float floatSqrt(float a, float){ return sqrtf(a); };
+static float floatSin(float a, float){ return sinf(a); };
+
+int main() {
+    for(int i = 0; i < BENCH_VALUES; i++) {
+        fixeds[i] = Fixed::ratio(i * 37 % 1000 + 1, 7);
+        floats[i] = (i * 37 % 1000 + 1) / 7.0f;
+    }
+
+    printf("FixedBench: host ns per operation (not AVR cycles)\n");
+    bench("mul", fixedMul, floatMul);
+    bench("div", fixedDiv, floatDiv);
+    bench("sqrt", fixedSqrt, floatSqrt);
+    bench("sin", fixedSin, floatSin);
+
+    return 0;
+};
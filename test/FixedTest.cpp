@@ -0,0 +1,237 @@
+/**
+ *  FixedTest.cpp
+ *
+ *  lib/Fixed against double. Every operation is swept over its range (and
+ *  random values) and the worst error is checked against the bound the
+ *  operation is built for, in raw units of 1/65536 (LSB).
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include <math.h>
+#include <stdlib.h>
+#include "Check.h"
+#include "lib/Fixed.h"
+
+// One raw unit
+#define LSB (1.0 / FIXED_ONE)
+
+/**
+ * Value of a Fixed
+ * @param  f Fixed
+ * @return   double
+ */
+static double value(Fixed f) {
+    return f.raw * LSB;
+};
+
+/**
+ * Random raw value
+ * @param  range Largest magnitude (raw)
+ * @return       -range to range
+ */
+static int32_t any(int32_t range) {
+    int64_t r = ((int64_t)rand() << 31) ^ rand();
+    return (int32_t)(r % ((int64_t)range * 2 + 1) - range);
+};
+
+/**
+ * Multiply, rounded to half an LSB while the product is in range
+ */
+static void multiply() {
+    double worst = 0;
+
+    srand(1);
+    for(int i = 0; i < 200000; i++) {
+
+        // Magnitudes spread over every size, product in range
+        int32_t a = any(FIXED_MAX >> (rand() % 31));
+        int32_t b = any(FIXED_MAX >> (rand() % 31));
+        double exact = (double)a * b * LSB * LSB;
+        if(fabs(exact) >= 32767) continue;
+
+        double error = fabs(value(Fixed::fromRaw(a) * Fixed::fromRaw(b)) - exact);
+        if(error > worst) worst = error;
+    }
+
+    // Signs and whole numbers
+    CHECK(Fixed(3) * Fixed(-4) == Fixed(-12));
+    CHECK(Fixed(-3) * Fixed(-4) == Fixed(12));
+    CHECK(Fixed::ratio(1, 2) * Fixed::ratio(-1, 2) == Fixed::ratio(-1, 4));
+
+    printf("  mul: worst %.2f LSB\n", worst / LSB);
+    CHECK(worst <= 0.5 * LSB);
+};
+
+/**
+ * Divide, to an LSB, saturating out of range
+ */
+static void divide() {
+    double worst = 0;
+
+    srand(2);
+    for(int i = 0; i < 200000; i++) {
+        int32_t a = any(FIXED_MAX >> (rand() % 31));
+        int32_t b = any(FIXED_MAX >> (rand() % 31));
+        if(b == 0) continue;
+        double exact = (double)a / b;
+        if(fabs(exact) >= 32767) continue;
+
+        double error = fabs(value(Fixed::fromRaw(a) / Fixed::fromRaw(b)) - exact);
+        if(error > worst) worst = error;
+    }
+
+    CHECK(Fixed(12) / Fixed(-4) == Fixed(-3));
+    CHECK(Fixed(1) / Fixed(0) == Fixed::fromRaw(FIXED_MAX));
+    CHECK(Fixed(-1) / Fixed(0) == Fixed::fromRaw(FIXED_MIN));
+    CHECK(Fixed(30000) / Fixed::ratio(1, 4) == Fixed::fromRaw(FIXED_MAX));
+    CHECK(Fixed(-30000) / Fixed::ratio(1, 4) == Fixed::fromRaw(FIXED_MIN));
+
+    printf("  div: worst %.2f LSB\n", worst / LSB);
+    CHECK(worst <= 1 * LSB);
+};
+
+/**
+ * Fractions, as the shapes build them from integers
+ */
+static void ratio() {
+    double worst = 0;
+
+    for(int num = -1000; num <= 1000; num += 7) {
+        for(int den = 1; den <= 1000; den += 13) {
+            double error = fabs(value(Fixed::ratio(num, den)) - (double)num / den);
+            if(error > worst) worst = error;
+        }
+    }
+
+    printf("  ratio: worst %.2f LSB\n", worst / LSB);
+    CHECK(worst <= 1 * LSB);
+};
+
+/**
+ * Square roots: Fixed::sqrt() under an LSB, root() under 1/256, isqrt()
+ * exact
+ */
+static void roots() {
+    double worstSqrt = 0;
+    double worstRoot = 0;
+    bool exact = true;
+
+    srand(3);
+    for(int i = 0; i < 200000; i++) {
+        int32_t a = any(FIXED_MAX >> (rand() % 31));
+        if(a < 0) a = -a;
+        double error = fabs(value(Fixed::sqrt(Fixed::fromRaw(a))) - ::sqrt(a * LSB));
+        if(error > worstSqrt) worstSqrt = error;
+
+        // root() takes under 2^30
+        unsigned long n = (unsigned long)a >> 1;
+        error = fabs(value(Fixed::root(n)) - ::sqrt((double)n));
+        if(error > worstRoot) worstRoot = error;
+
+        unsigned long r = Fixed::isqrt(n);
+        if(r * r > n || (r + 1) * (r + 1) <= n) exact = false;
+    }
+
+    // Squares, and the top of the range
+    for(unsigned long r = 0; r < 65536; r += 3) {
+        unsigned long n = r * r;
+        if(Fixed::isqrt(n) != r || (n > 0 && Fixed::isqrt(n - 1) != r - 1)) exact = false;
+    }
+    if(Fixed::isqrt(0xFFFFFFFFUL) != 65535) exact = false;
+
+    CHECK(Fixed::sqrt(Fixed(-4)) == Fixed());
+    CHECK(Fixed::sqrt(Fixed(4)) == Fixed(2));
+    CHECK(Fixed::root(0) == Fixed());
+
+    printf("  sqrt: worst %.3f LSB, root: worst %.3f LSB\n", worstSqrt / LSB, worstRoot / LSB);
+    CHECK(worstSqrt < 1 * LSB);
+    CHECK(worstRoot < 256 * LSB);
+    CHECK(exact);
+};
+
+/**
+ * Sine and cosine over a few turns either way, within the ~4e-5 of the
+ * Taylor series (plus the rounding of each multiply)
+ */
+static void trig() {
+    double worst = 0;
+
+    for(int32_t a = -4 * FIXED_TWO_PI.raw; a <= 4 * FIXED_TWO_PI.raw; a += 97) {
+        Fixed f = Fixed::fromRaw(a);
+        double s = fabs(value(Fixed::sin(f)) - ::sin(a * LSB));
+        double c = fabs(value(Fixed::cos(f)) - ::cos(a * LSB));
+        if(s > worst) worst = s;
+        if(c > worst) worst = c;
+    }
+
+    CHECK(Fixed::sin(Fixed()) == Fixed());
+    CHECK(abs(Fixed::sin(FIXED_HALF_PI).raw - FIXED_ONE) <= 1);
+
+    printf("  sin/cos: worst %.1e\n", worst);
+    CHECK(worst <= 5e-5);
+};
+
+/**
+ * Degrees to radians over two turns either way. pi is rounded and the
+ * result truncated, under 3 LSB.
+ */
+static void angles() {
+    double worst = 0;
+
+    for(int deg = -720; deg <= 720; deg++) {
+        double error = fabs(value(Fixed::fromDegrees(deg)) - deg * M_PI / 180);
+        if(error > worst) worst = error;
+    }
+
+    printf("  fromDegrees: worst %.2f LSB\n", worst / LSB);
+    CHECK(worst < 3 * LSB);
+};
+
+/**
+ * Scale, floor(n * f) exactly and saturating at the top
+ */
+static void scale() {
+    bool exact = true;
+
+    srand(4);
+    for(int i = 0; i < 200000; i++) {
+        unsigned long n = (((unsigned long)rand() << 16 ^ rand()) & 0xFFFFFFFFUL) >> (rand() % 32);
+        int32_t f = any(FIXED_MAX >> (rand() % 31));
+        if(f < 0) f = -f;
+
+        // Exact in 64 bits
+        uint64_t full = ((uint64_t)n * (uint32_t)f) >> 16;
+        unsigned long want = full > 0xFFFFFFFFULL ? 0xFFFFFFFFUL : (unsigned long)full;
+        if(Fixed::scale(n, Fixed::fromRaw(f)) != want) exact = false;
+    }
+
+    CHECK(Fixed::scale(1000, Fixed(-1)) == 0);
+    CHECK(Fixed::scale(0xFFFFFFFFUL, Fixed(2)) == 0xFFFFFFFFUL);
+    CHECK(exact);
+};
+
+/**
+ * Rounding to integers
+ */
+static void ints() {
+    CHECK(Fixed::ratio(5, 2).toInt() == 3);
+    CHECK(Fixed::ratio(-5, 2).toInt() == -2);
+    CHECK(Fixed::ratio(7, 3).toInt() == 2);
+    CHECK(Fixed::ratio(-7, 3).floor() == -3);
+    CHECK(Fixed(-32768).toInt() == -32768);
+};
+
+int main() {
+    multiply();
+    divide();
+    ratio();
+    roots();
+    trig();
+    angles();
+    scale();
+    ints();
+
+    return Check::done("FixedTest");
+};
@@ -0,0 +1,94 @@
+/**
+ *  LimitTest.cpp
+ *
+ *  The limit switches. Running into one stops the steps and sends the pen
+ *  home once it is lifted, and the moves after homing (which start with both
+ *  origin switches still closed) are drawn, not taken for another hit.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Check.h"
+#include "Plotter.h"
+
+static Drive &drive = Plotter::drive;
+
+// Where the switches close (steps), homing steps up to HOME
+#define HOME 50
+#define FAR  -300
+
+/**
+ * Running into the far switch stops the line there and homes
+ */
+static void hit() {
+    drive.lineTo(-400, -100);
+    drive.sync();
+
+    CHECK(Plotter::position().x == HOME);
+    CHECK(Plotter::position().y == HOME);
+    CHECK(drive.get().x == 0 && drive.get().y == 0);
+
+    // It got to the switch and no further than the debounce lets it
+    long furthest = 0;
+    long x = 0;
+    for(size_t i = 0; i < Sim::steps().size(); i++) {
+        if(Sim::steps()[i].axis != PLOTTER_X) continue;
+        x += Sim::steps()[i].dir;
+        if(x < furthest) furthest = x;
+    }
+    CHECK(furthest <= FAR);
+    CHECK(furthest > FAR - 10);
+
+    // Homing waits for the pen to lift (71 degrees at 5ms each, timed in
+    // whole ms) first
+    CHECK(Sim::servo() == 0);
+    size_t first = 0;
+    while(first < Sim::steps().size() && Sim::steps()[first].us < Sim::servoTime()) first++;
+    CHECK(first < Sim::steps().size());
+    if(first < Sim::steps().size()) CHECK(Sim::steps()[first].us >= Sim::servoTime() + 71UL * 5 * 1000 - 1000);
+};
+
+/**
+ * Along x off its origin switch after homing, y stays on its own
+ */
+static void along() {
+    Sim::steps().clear();
+
+    drive.lineTo(-100, 0);
+    drive.sync();
+
+    CHECK(drive.get().x == -100 && drive.get().y == 0);
+    CHECK(Plotter::position().x == HOME - 100);
+    CHECK(Plotter::position().y == HOME);
+    CHECK(Plotter::steps(PLOTTER_X) == 100);
+    CHECK(Plotter::steps(PLOTTER_Y) == 0);
+};
+
+/**
+ * Off the other origin switch, a line that moves both axes is drawn in full
+ */
+static void away() {
+    Sim::steps().clear();
+
+    drive.lineTo(-200, -60);
+    drive.sync();
+
+    CHECK(drive.get().x == -200 && drive.get().y == -60);
+    CHECK(Plotter::position().x == HOME - 200);
+    CHECK(Plotter::position().y == HOME - 60);
+    CHECK(Plotter::steps(PLOTTER_X) == 100);
+    CHECK(Plotter::steps(PLOTTER_Y) == 60);
+};
+
+int main() {
+    Plotter::attach();
+    Plotter::limits(HOME, FAR);
+
+    Sim::steps().clear();
+    hit();
+    along();
+    away();
+
+    return Check::done("LimitTest");
+};
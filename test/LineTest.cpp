@@ -0,0 +1,82 @@
+/**
+ *  LineTest.cpp
+ *
+ *  Lines stepped out by the DDA in Drive::plan() against the ideal line.
+ *  After every step the pen is within half a step of the line (measured
+ *  along the minor axis), each tick steps the major axis once, and the
+ *  steps add up to the end point.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#include <math.h>
+#include "Check.h"
+#include "Plotter.h"
+
+static Drive &drive = Plotter::drive;
+
+/**
+ * Draw a line and follow the steps, checking each point against the line
+ * @param dx Steps along x
+ * @param dy Steps along y
+ */
+static void line(int dx, int dy) {
+    POS from = Plotter::position();
+
+    Sim::steps().clear();
+    drive.lineTo(from.x + dx, from.y + dy);
+    drive.sync();
+
+    int major = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+    bool xMajor = abs(dx) >= abs(dy);
+
+    // Replay the steps tick by tick
+    std::vector<PlotterTick> ticks = Plotter::ticks(0, 0);
+    long x = 0;
+    long y = 0;
+    double worst = 0;
+    bool monotonic = true;
+
+    for(size_t i = 0; i < ticks.size(); i++) {
+        if((ticks[i].x - x) * dx < 0 || (ticks[i].y - y) * dy < 0) monotonic = false;
+        x = ticks[i].x;
+        y = ticks[i].y;
+
+        // Distance from the line along the minor axis
+        double error = xMajor ? fabs(y - (double)dy * x / dx) : fabs(x - (double)dx * y / dy);
+        if(error > worst) worst = error;
+    }
+
+    printf("  (%d, %d): %u ticks, worst %.3f steps off\n", dx, dy, (unsigned int)ticks.size(), worst);
+
+    CHECK(x == dx && y == dy);
+    CHECK(Plotter::position().x == from.x + dx && Plotter::position().y == from.y + dy);
+    CHECK((int)ticks.size() == major);
+    CHECK(monotonic);
+    CHECK(worst <= 0.5);
+};
+
+int main() {
+    Plotter::attach();
+
+    // Along the axes, diagonals, shallow and steep, every direction
+    line(100, 0);
+    line(0, 100);
+    line(100, 100);
+    line(-100, -100);
+    line(100, 1);
+    line(1, 100);
+    line(300, 7);
+    line(-7, 300);
+    line(255, -254);
+    line(-301, 113);
+    line(97, -398);
+    line(1000, 999);
+
+    // Many short lines, the rounding of one does not carry to the next
+    srand(3);
+    for(int i = 0; i < 20; i++) line(rand() % 61 - 30, rand() % 61 - 30);
+
+    return Check::done("LineTest");
+};
@@ -0,0 +1,256 @@
+/**
+ *  LinkTest.cpp
+ *
+ *  main.cpp on the simulated Uno, sent a job by the simulated client.js
+ *  (sim/Client.h): circles of radius 0, so the time is the link's and not
+ *  the drawing's. Every shape has to be drawn, once and in order, with no
+ *  receive bytes lost. The times are printed.
+ *
+ *  The same 1000 circles go as text (a ;next; round trip per token) and as
+ *  frames, at 9600 baud (the plotter's own) and at 115200 (what client.js
+ *  asks for), and as frames with some lost on the way: a frame after a lost
+ *  one is nak'd, so it is sent again without waiting out the Sender's
+ *  timer. One job has a circle in the middle that takes longer to draw than
+ *  the Sender's timer: the plotter keeps reading and acking while its moves
+ *  wait on room in the queue, so nothing is sent again. Then fewer go over
+ *  a pty in real time, with node putting in latency before everything it
+ *  writes: with the window of frames in flight a long round trip costs next
+ *  to nothing, sent one at a time (stop and wait) each frame waits for it.
+ *
+ *  Each job runs in a process of its own (forked), as the plotter is a
+ *  fresh one for each. The frames are sent by client/Link.js, in node.
+ *
+ *  @author Drew Sommer
+ *  @version 1.2.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include "Check.h"
+#include "Sim.h"
+#include "Client.h"
+#include "lib/Uart.h"
+
+// Circles in the job, and in the ones over a pty (they take real time)
+#define LINK_CIRCLES 1000
+#define LINK_PTY_CIRCLES 300
+
+// Latency of the host and USB turning a reply around, and a long one (us)
+#define LINK_LATENCY 2000
+#define LINK_SLOW 200000
+
+// Every nth frame is lost in the lossy job
+#define LINK_LOSE 10
+
+// Radius of the circle midway through the long job, longer to draw than
+// the Sender's timer
+#define LINK_LONG 2000
+
+// Longest a job may take (us)
+#define LINK_LIMIT 3600000000UL
+
+// main.cpp
+extern bool set, pen, draw;
+void setup();
+void loop();
+
+/**
+ * How a job is sent
+ */
+struct Send {
+    int circles;           // Circles in the job
+    bool binary;           // Frames, or text
+    bool window;           // Frames up to the credit in flight, or one at a time
+    unsigned long latency; // Host turnaround (us)
+    unsigned long baud;    // Baud the client asks for, 0 for 9600
+    bool pty;              // Over a pty in real time, or in lockstep
+    unsigned long lose;    // Every nth frame is lost, 0 for none
+    int radius;            // Radius of the circle midway, 0 for none
+};
+
+/**
+ * How a job went
+ */
+struct Job {
+    bool done;             // Finished within LINK_LIMIT
+    double listed;         // Whole list sent (s)
+    double took;           // Drawing done and the pen home (s)
+    unsigned long drawn;   // Circles drawn
+    unsigned long order;   // Circles drawn out of order (or twice)
+    unsigned long lost;    // Receive bytes the plotter lost
+    unsigned long bytes;   // Bytes sent to the plotter
+    unsigned long frames;  // Frames sent, sent again ones included
+};
+
+// Result of the job running in this process, and where it goes
+static Job result;
+static int report = -1;
+
+/**
+ * Command list of the job, as SVG_Parser makes it
+ * @param  n      Circles
+ * @param  radius Radius of the one midway (the rest are 0)
+ * @return        Tokens
+ */
+static std::vector<std::string> circles(int n, int radius) {
+    const char *speeds[] = { "p", "F", "100;", "600;", "1000;", "q", "p", "R", "100;", "1000;", "2000;", "q" };
+    std::vector<std::string> list(1, "n");
+    list.insert(list.end(), speeds, speeds + sizeof(speeds) / sizeof(speeds[0]));
+
+    for(int i = 0; i < n; i++) {
+        char cx[16], r[16];
+        snprintf(cx, sizeof(cx), "%d;", i);
+        snprintf(r, sizeof(r), "%d;", i == n / 2 ? radius : 0);
+
+        list.push_back("p");
+        list.push_back("C");
+        list.push_back(cx);
+        list.push_back("100;");
+        list.push_back(r);
+        list.push_back("q");
+    }
+
+    list.push_back("u");
+    return list;
+};
+
+/**
+ * Fill in the result from what the plotter sent, and hand it to the parent
+ */
+static void finish() {
+    std::vector<std::string> &lines = Client::lines();
+    bool drawing = false;
+    long next = 0;
+
+    for(size_t i = 0; i < lines.size(); i++) {
+        unsigned long dropped, overrun;
+        long cx;
+
+        if(lines[i] == "Start drawing") drawing = true;
+        if(drawing && sscanf(lines[i].c_str(), "C(%ld,", &cx) == 1) {
+            if(cx != next) result.order++;
+            next = cx + 1;
+            result.drawn++;
+        }
+        if(sscanf(lines[i].c_str(), "RX lost: dropped %lu, overrun %lu", &dropped, &overrun) == 2) {
+            result.lost = dropped + overrun;
+        }
+    }
+
+    result.listed = Client::listed() / 1e6;
+    result.took = Sim::now() / 1e6;
+    result.bytes = Client::bytes();
+    result.frames = Client::frames();
+
+    if(write(report, &result, sizeof(result)) != sizeof(result)) _exit(2);
+    _exit(0);
+};
+
+/**
+ * Every millisecond, the client's timer and the time limit
+ */
+static void tick() {
+    Client::tick();
+    if(Sim::now() >= LINK_LIMIT) finish();
+};
+
+/**
+ * Send the job to a fresh plotter and draw it
+ * @param  send How it is sent
+ * @return      How it went
+ */
+static Job run(const Send &send) {
+    Job job = {};
+    int fds[2];
+    if(pipe2(fds, O_CLOEXEC) != 0) return job;
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if(pid == 0) {
+        close(fds[0]);
+        report = fds[1];
+
+        // Start pressed from the first, the pen is set as soon as it can be
+        Sim::analog(2, 1023);
+        Sim::onMillis = tick;
+        if(send.pty) Client::startPty(circles(send.circles, send.radius), send.window, send.latency, send.baud);
+        else Client::start(circles(send.circles, send.radius), send.binary, send.window, send.latency, send.baud);
+        Client::lose(send.lose);
+
+        setup();
+        do {
+            loop();
+        } while(set || pen || draw);
+
+        uart.flush();
+        result.done = true;
+        finish();
+    }
+
+    close(fds[1]);
+    if(pid < 0 || read(fds[0], &job, sizeof(job)) != sizeof(job)) job.done = false;
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+
+    return job;
+};
+
+/**
+ * Send a job, print how it went and check every circle was drawn, in
+ * order, with nothing lost
+ * @param  name Name to print
+ * @param  send How it is sent
+ * @return      How it went
+ */
+static Job check(const char *name, const Send &send) {
+    Job job = run(send);
+
+    printf("  %-24s sent in %6.1fs, done in %6.1fs, %lu bytes, %lu frames, %lu drawn, %lu lost\n",
+        name, job.listed, job.took, job.bytes, job.frames, job.drawn, job.lost);
+
+    CHECK(job.done);
+    CHECK(job.drawn == (unsigned long)send.circles);
+    CHECK(job.order == 0);
+    CHECK(job.lost == 0);
+
+    return job;
+};
+
+int main() {
+
+    //                                              circles           binary window latency       baud    pty    lose       radius
+    Job text = check("text 9600", (Send){           LINK_CIRCLES,     false, true,  LINK_LATENCY, 0,      false, 0,         0 });
+    Job frames = check("frames 9600", (Send){       LINK_CIRCLES,     true,  true,  LINK_LATENCY, 0,      false, 0,         0 });
+    Job textFast = check("text 115200", (Send){     LINK_CIRCLES,     false, true,  LINK_LATENCY, 115200, false, 0,         0 });
+    Job framesFast = check("frames 115200", (Send){ LINK_CIRCLES,     true,  true,  LINK_LATENCY, 115200, false, 0,         0 });
+
+    CHECK(frames.took < text.took / 2);
+    CHECK(framesFast.took < textFast.took / 2);
+
+    // Lost frames sent again as soon as a frame after them is in, not after
+    // the Sender's timer (10s a frame)
+    Job lossy = check("frames 115200 lossy", (Send){ LINK_CIRCLES,    true,  true,  LINK_LATENCY, 115200, false, LINK_LOSE, 0 });
+
+    CHECK(lossy.frames > framesFast.frames);
+    CHECK(lossy.took < framesFast.took + 5);
+
+    // Frames taken in and acked while the long circle is queued, none sent
+    // again by the Sender's timer
+    Job slow = check("frames 115200 long", (Send){  LINK_CIRCLES,     true,  true,  LINK_LATENCY, 115200, false, 0,         LINK_LONG });
+
+    CHECK(slow.frames == framesFast.frames);
+
+    // Over a pty, the round trip hidden by the window and not by stop and wait
+    Job near = check("pty window 2ms", (Send){      LINK_PTY_CIRCLES, true,  true,  LINK_LATENCY, 115200, true,  0,         0 });
+    Job far = check("pty window 200ms", (Send){     LINK_PTY_CIRCLES, true,  true,  LINK_SLOW,    115200, true,  0,         0 });
+    Job stop = check("pty stop and wait 200ms", (Send){ LINK_PTY_CIRCLES, true, false, LINK_SLOW, 115200, true,  0,         0 });
+
+    // (the credit is a 127 byte receive ring a round trip, so 200ms still
+    // costs some)
+    CHECK(far.took < stop.took * 0.9);
+    CHECK(far.took < near.took * 2.5);
+
+    return Check::done("LinkTest");
+};
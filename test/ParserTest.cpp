@@ -0,0 +1,262 @@
+/**
+ *  ParserTest.cpp
+ *
+ *  The text protocol's Parser fed byte streams through the simulated USART,
+ *  the way main.cpp runs it (read() and take() every pass, never waiting).
+ *
+ *  A valid stream of random shapes (values past the int16 limits, polygons
+ *  long enough to be added in pieces) has to fill the shape table exactly as
+ *  adding the shapes to it directly does, with no bytes lost. How fast it is
+ *  taken in is printed and checked against the line: the ;next; sent for
+ *  each token is the limit, not the Parser.
+ *
+ *  A random stream (mostly token bytes, some any byte) only has to leave the
+ *  Parser and the table sound: nothing lost, the table within its size, and
+ *  a shape sent after it parsed as it should be. Run it under ASan and UBSan
+ *  with make sanitize.
+ *
+ *  The table is printed and emptied when a batch is in (or it is full),
+ *  as drawing would empty it.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "Check.h"
+#include "Plotter.h"
+#include "Parser.h"
+#include "Link.h"
+
+// Baud the stream comes in at
+#define PARSER_BAUD 115200
+
+// Shapes in the valid stream, batches of the random one
+#define PARSER_SHAPES 2000
+#define PARSER_BATCHES 2000
+
+// Longest polygon in the valid stream (points)
+#define PARSER_POINTS 24
+
+static ShapeTable shapes;
+static Parser parser(&shapes);
+static std::vector<std::string> printed; // Shapes printed from the table
+
+/**
+ * Lines the Uart sends for some output
+ * @param  table Table to print
+ * @return       Lines
+ */
+static std::vector<std::string> print(ShapeTable &table) {
+    uart.flush();
+    Sim::sent().clear();
+    table.print();
+    uart.flush();
+
+    std::vector<std::string> lines;
+    std::string &sent = Sim::sent();
+    size_t start = 0, end;
+    while((end = sent.find("\r\n", start)) != std::string::npos) {
+        lines.push_back(sent.substr(start, end - start));
+        start = end + 2;
+    }
+    Sim::sent().clear();
+    return lines;
+};
+
+/**
+ * Print the shapes in the table and empty it
+ */
+static void drain() {
+    std::vector<std::string> lines = print(shapes);
+    printed.insert(printed.end(), lines.begin(), lines.end());
+    CHECK(shapes.used() <= SHAPE_TABLE_SIZE);
+    shapes = ShapeTable();
+};
+
+/**
+ * Send bytes and run the Parser until every one is taken in (a LINK_START
+ * is taken by the Link, it is dropped here)
+ * @param bytes Bytes
+ */
+static void pump(const std::string &bytes) {
+    Sim::send(bytes);
+
+    do {
+        parser.read();
+        if(uart.peek() == LINK_START) uart.read();
+        if(!parser.take()) drain();
+        Sim::run(1);
+    } while(Sim::sending() > 0 || uart.available() > 0);
+
+    parser.read();
+    parser.take();
+};
+
+/**
+ * Random value, sometimes past the int16 limits
+ * @param  text  Text the token is appended to
+ * @return       Value the Parser holds for it
+ */
+static int value(std::string &text) {
+    long v;
+    switch(rand() % 8) {
+        case 0:  v = rand() % 200000 - 100000; break;
+        case 1:  v = rand() % 20 - 10; break;
+        default: v = rand() % 65536 - 32768;
+    }
+
+    char token[16];
+    snprintf(token, sizeof(token), "%ld;", v);
+    text += token;
+    return constrain(v, -32768, 32767);
+};
+
+/**
+ * A random shape as text, and added to a table directly
+ * @param text   Text it is appended to
+ * @param expect Table it is added to
+ */
+static void shape(std::string &text, ShapeTable &expect) {
+    const char types[] = { 'C', 'E', 'E', 'B', 'P', 'P', 'F', 'R' };
+    char type = types[rand() % sizeof(types)];
+    std::vector<int> values;
+
+    text += 'p';
+    text += type;
+
+    if(type == 'P') {
+        int n = 2 * (1 + rand() % PARSER_POINTS);
+
+        // Added in pieces of PARSER_VALUES, each from the last point of
+        // the one before
+        for(int i = 0; i < n; i++) {
+            values.push_back(value(text));
+            if(values.size() == PARSER_VALUES) {
+                expect.add(SHAPE_POLYGON, values.size());
+                for(size_t j = 0; j < values.size(); j++) expect.set(j, values[j]);
+                values.erase(values.begin(), values.end() - 2);
+            }
+        }
+        text += 'q';
+        expect.add(SHAPE_POLYGON, values.size());
+        for(size_t j = 0; j < values.size(); j++) expect.set(j, values[j]);
+        return;
+    }
+
+    uint8_t record = type == 'C' ? SHAPE_CIRCLE :
+                     type == 'B' ? SHAPE_BEZIER :
+                     type == 'F' ? SHAPE_FEED :
+                     type == 'R' ? SHAPE_RAPID :
+                     rand() % 2 ? SHAPE_ROTATED : SHAPE_ELLIPSE;
+
+    for(int i = 0; i < ShapeTable::values(record); i++) values.push_back(value(text));
+    text += 'q';
+
+    expect.add(record, values.size());
+    for(size_t j = 0; j < values.size(); j++) expect.set(j, values[j]);
+};
+
+/**
+ * A valid stream fills the table as adding the shapes does, as fast as the
+ * line allows
+ */
+static void valid() {
+    std::vector<std::string> expected;
+    unsigned long bytes = 0, took = 0;
+    int n = 0;
+
+    srand(24);
+    printed.clear();
+    pump("n");
+
+    while(n < PARSER_SHAPES) {
+
+        // A batch of shapes the receive ring holds, so the table holds them
+        // too (their text takes at least the bytes of their records)
+        std::string text, next;
+        ShapeTable expect;
+        while(n < PARSER_SHAPES) {
+            ShapeTable more = expect;
+            shape(next, more);
+            if(text.size() + next.size() >= UART_RX_SIZE) break;
+
+            text += next;
+            next.clear();
+            expect = more;
+            n++;
+        }
+        if(text.empty()) continue;
+
+        unsigned long start = Sim::now();
+        pump(text);
+        took += Sim::now() - start;
+        bytes += text.size();
+
+        CHECK(!parser.busy());
+        drain();
+
+        std::vector<std::string> lines = print(expect);
+        expected.insert(expected.end(), lines.begin(), lines.end());
+    }
+
+    double rate = bytes * 1e6 / took;
+    printf("  valid: %d shapes, %lu bytes at %.0f bytes/s (the line %d)\n", n, bytes, rate, PARSER_BAUD / 10);
+
+    CHECK(printed.size() == expected.size());
+    CHECK(printed == expected);
+    CHECK(uart.dropped() == 0 && uart.overrun() == 0);
+    CHECK(rate > PARSER_BAUD / 10 / 4);
+};
+
+/**
+ * A random stream leaves the Parser and table sound
+ */
+static void randoms() {
+    // Every token, or no q so shapes run past the values held
+    const char *tokens[] = { "npqu;-0123456789CEBPFR", "p;-0123456789CEBPFR" };
+    unsigned long added = 0;
+
+    srand(7);
+    printed.clear();
+    for(int i = 0; i < PARSER_BATCHES; i++) {
+        const char *set = tokens[rand() % 2];
+        std::string bytes;
+        int n = rand() % UART_RX_SIZE;
+
+        for(int j = 0; j < n; j++) {
+            if(rand() % 8 == 0) bytes += (char)(rand() % 256);
+            else bytes += set[rand() % strlen(set)];
+        }
+
+        pump(bytes);
+        drain();
+        added += printed.size();
+        printed.clear();
+    }
+
+    printf("  random: %d batches, %lu shapes added\n", PARSER_BATCHES, added);
+    CHECK(added > 0);
+    CHECK(uart.dropped() == 0 && uart.overrun() == 0);
+
+    // Whatever the stream left it in the middle of ends, then a shape
+    pump("xq");
+    drain();
+    printed.clear();
+    pump("pC1;-2;30000;q");
+    drain();
+
+    CHECK(!parser.busy());
+    CHECK(printed.size() == 1 && printed[0] == "C(1,-2,30000)");
+};
+
+int main() {
+    Plotter::attach();
+    uart.begin(PARSER_BAUD);
+
+    valid();
+    randoms();
+
+    return Check::done("ParserTest");
+};
@@ -0,0 +1,158 @@
+/**
+ *  RampTest.cpp
+ *
+ *  The trapezoidal Ramp against the profile it is given: the speed of each
+ *  step is compared with the ideal trapezoid (accelerate at accel from the
+ *  entry speed, cruise, decelerate at accel to the exit speed). Then a line
+ *  is stepped out by the Drive and the time of each step is checked against
+ *  the delays the Ramp hands out. A stepper's default profile is checked
+ *  for any delay.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#include <math.h>
+#include "Check.h"
+#include "Plotter.h"
+#include "stepper/Ramp.h"
+#include "stepper/Stepper.h"
+
+// Most the speed of a step may be off the ideal trapezoid. The recurrence is
+// an approximation, worst on the last steps of the slow down.
+#define RAMP_TOLERANCE 0.10
+
+/**
+ * Speed of the ideal trapezoid at a step
+ * @param  p     Profile
+ * @param  entry Entry speed (steps/s)
+ * @param  exit  Exit speed (steps/s)
+ * @param  steps Steps in the move
+ * @param  i     Step
+ * @return       Speed (steps/s)
+ */
+static double ideal(Profile p, double entry, double exit, unsigned long steps, unsigned long i) {
+    double up = sqrt(entry * entry + 2.0 * p.accel * i);
+    double down = sqrt(exit * exit + 2.0 * p.accel * (steps - 1 - i));
+    return fmin(fmin(up, down), (double)p.speed);
+};
+
+/**
+ * Step the Ramp through a move and compare every step with the trapezoid
+ * @param p     Profile
+ * @param steps Steps in the move
+ * @param entry Entry speed (steps/s)
+ * @param exit  Exit speed (steps/s)
+ */
+static void trapezoid(Profile p, unsigned long steps, unsigned int entry, unsigned int exit) {
+    Ramp ramp;
+    ramp.begin(steps, p, entry, exit);
+
+    double worst = 0;
+    double fastest = 0;
+    double slowest = p.speed;
+    double first = 0;
+    double last = 0;
+
+    for(unsigned long i = 0; i < steps; i++) {
+        double v = 1e6 / ramp.next();
+        double error = fabs(v - ideal(p, entry, exit, steps, i)) / ideal(p, entry, exit, steps, i);
+
+        if(error > worst) worst = error;
+        if(v > fastest) fastest = v;
+        if(v < slowest) slowest = v;
+        if(i == 0) first = v;
+        last = v;
+    }
+
+    printf("  %5lu steps %3u -> %3u: worst %.1f%%, %.0f to %.0f steps/s\n",
+        steps, entry, exit, worst * 100, slowest, fastest);
+
+    CHECK(worst <= RAMP_TOLERANCE);
+    CHECK(ramp.left() == 0);
+
+    // Delays are whole us, speeds can round up a little
+    CHECK(fastest <= p.speed * 1.01);
+    CHECK(slowest >= p.start * 0.99);
+    CHECK(fabs(first - entry) <= entry * 0.01);
+    CHECK(fabs(last - exit) <= exit * RAMP_TOLERANCE);
+};
+
+/**
+ * Moves long enough to cruise, too short to, and starting or ending on the
+ * move
+ */
+static void profiles() {
+    Profile p = Plotter::feed;
+
+    trapezoid(p, 2000, p.start, p.start);
+    trapezoid(p, 200, p.start, p.start);
+    trapezoid(p, 30, p.start, p.start);
+    trapezoid(p, 2000, 400, p.start);
+    trapezoid(p, 2000, p.start, 500);
+    trapezoid(p, 200, 400, 300);
+    trapezoid(Plotter::rapid, 5000, Plotter::rapid.start, Plotter::rapid.start);
+};
+
+/**
+ * A line stepped out by the Drive, each step comes when the Ramp said. The
+ * timer waits in whole 2us ticks and splits long waits, a step may be off
+ * by a couple of ticks but they never add up.
+ */
+static void timer() {
+    const unsigned long steps = 2000;
+    Profile p = Plotter::feed;
+
+    Sim::steps().clear();
+    Plotter::drive.lineTo(steps, 0);
+    Plotter::drive.sync();
+    CHECK(Sim::steps().size() == steps);
+    if(Sim::steps().size() != steps) return;
+
+    Ramp ramp;
+    ramp.begin(steps, p);
+    ramp.next(); // Before the first step, that is when the pen was down
+
+    long worst = 0;
+    unsigned long planned = 0;
+    for(unsigned long i = 1; i < steps; i++) {
+        long c = ramp.next();
+        long d = Sim::steps()[i].us - Sim::steps()[i - 1].us;
+        if(labs(d - c) > labs(worst)) worst = d - c;
+        planned += c;
+    }
+    unsigned long took = Sim::steps()[steps - 1].us - Sim::steps()[0].us;
+
+    printf("  timer: worst step %ldus off, %luus for %luus planned\n", worst, took, planned);
+
+    CHECK(labs(worst) <= 4);
+    CHECK(fabs((double)took - planned) <= planned * 0.001);
+};
+
+/**
+ * The default profile of a stepper is never slower than 1 step/s, whatever
+ * its delay, so a Ramp started from it never divides by 0
+ */
+static void defaults() {
+    PinMap map = { 0, 1, 2, 0, 0, 0, 0, 0 };
+    int dels[] = { 1, 5, 499, 500, 501, 10000, 0 };
+
+    for(size_t i = 0; i < sizeof(dels) / sizeof(dels[0]); i++) {
+        Profile p = Stepper(map, dels[i]).getProfile();
+        CHECK(p.start >= 1 && p.speed >= p.start && p.accel >= 1);
+
+        Ramp ramp;
+        ramp.begin(10, p);
+        CHECK(ramp.next() > 0);
+    }
+};
+
+int main() {
+    Plotter::attach();
+
+    profiles();
+    timer();
+    defaults();
+
+    return Check::done("RampTest");
+};
@@ -0,0 +1,221 @@
+/**
+ *  RapidTest.cpp
+ *
+ *  Pen up moves (moveTo) take the rapid profile, lines (lineTo) the drawing
+ *  one. The speed of every step is checked against the profile of the move
+ *  it belongs to, including the corners between the two kinds of move.
+ *  Speed limit records are turned down under 1 and held at the most the
+ *  steppers take.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Check.h"
+#include "Plotter.h"
+#include "shapes/ShapeTable.h"
+#include "lib/Uart.h"
+
+static Drive &drive = Plotter::drive;
+
+// Steps closer together than this (us) are the two axes of one tick
+#define RAPID_TICK 100
+
+/**
+ * Fastest and slowest speed of the steps in part of the log
+ * @param from    First step
+ * @param to      Past the last step
+ * @param fastest Fastest (steps/s)
+ * @param slowest Slowest (steps/s)
+ */
+static void speeds(size_t from, size_t to, double &fastest, double &slowest) {
+    fastest = 0;
+    slowest = 1e9;
+
+    const std::vector<SimStep> &steps = Sim::steps();
+    unsigned long last = 0;
+    bool first = true;
+
+    for(size_t i = from; i < to; i++) {
+        if(!first && steps[i].us - last < RAPID_TICK) continue;
+        if(!first) {
+            double v = 1e6 / (steps[i].us - last);
+            if(v > fastest) fastest = v;
+            if(v < slowest) slowest = v;
+        }
+        last = steps[i].us;
+        first = false;
+    }
+};
+
+/**
+ * A long move of each kind gets to its own cruise speed
+ */
+static void cruise() {
+    double fastest, slowest;
+
+    Sim::steps().clear();
+    drive.moveTo(2000, 0);
+    drive.sync();
+    speeds(0, Sim::steps().size(), fastest, slowest);
+    printf("  moveTo: %.0f to %.0f steps/s\n", slowest, fastest);
+
+    CHECK(Sim::steps().size() == 2000);
+    CHECK(fastest <= Plotter::rapid.speed * 1.01);
+    CHECK(fastest >= Plotter::rapid.speed * 0.99);
+
+    Sim::steps().clear();
+    drive.lineTo(0, 0);
+    drive.sync();
+    speeds(0, Sim::steps().size(), fastest, slowest);
+    printf("  lineTo: %.0f to %.0f steps/s\n", slowest, fastest);
+
+    CHECK(Sim::steps().size() == 2000);
+    CHECK(fastest <= Plotter::feed.speed * 1.01);
+    CHECK(fastest >= Plotter::feed.speed * 0.99);
+};
+
+/**
+ * Moves of both kinds one after another, going on without a stop where they
+ * can. No step of a line is ever faster than the drawing profile.
+ */
+static void mixed() {
+    std::vector<size_t> ends;    // End of each move in the step log
+    std::vector<bool> up;        // Move was pen up
+    size_t total = 0;
+
+    Sim::steps().clear();
+    POS at = Plotter::position();
+    for(int i = 0; i < 24; i++) {
+        int x = 300 * (i / 4) + (i % 4 < 2 ? 300 : 150);
+        int y = i % 4 == 0 ? 0 : i % 4 == 2 ? 800 : 400;
+        if(i % 2 == 0) drive.moveTo(x, y);
+        else drive.lineTo(x, y);
+
+        // Every step of either axis is logged
+        total += abs(x - at.x) + abs(y - at.y);
+        ends.push_back(total);
+        up.push_back(i % 2 == 0);
+        at = { x, y };
+    }
+    drive.sync();
+
+    CHECK(Sim::steps().size() == total);
+    if(Sim::steps().size() != total) return;
+
+    double lineFastest = 0;
+    double rapidFastest = 0;
+    size_t from = 0;
+    for(size_t i = 0; i < ends.size(); i++) {
+        double fastest, slowest;
+        speeds(from, ends[i], fastest, slowest);
+        if(up[i] && fastest > rapidFastest) rapidFastest = fastest;
+        if(!up[i] && fastest > lineFastest) lineFastest = fastest;
+        from = ends[i];
+    }
+    printf("  mixed: lines up to %.0f, rapids up to %.0f steps/s\n", lineFastest, rapidFastest);
+
+    CHECK(lineFastest <= Plotter::feed.speed * 1.01);
+    CHECK(rapidFastest <= Plotter::rapid.speed * 1.01);
+    CHECK(rapidFastest > Plotter::feed.speed * 1.1);
+};
+
+/**
+ * Start speeds under 8 steps/s wait more ticks than fit 16 bits (the int of
+ * the Uno, 32 bits here), the step still comes on time
+ */
+static void slow() {
+    Profile crawl = { 2, 20, 40 };
+    drive.setRapid(crawl, crawl);
+
+    Sim::steps().clear();
+    POS at = Plotter::position();
+    drive.moveTo(at.x + 10, at.y);
+    drive.sync();
+
+    CHECK(Sim::steps().size() == 10);
+    if(Sim::steps().size() == 10) {
+        unsigned long first = Sim::steps()[1].us - Sim::steps()[0].us;
+        printf("  slow: second step after %luus\n", first);
+        CHECK(first > 100000);
+        CHECK(first <= 500000);
+    }
+
+    drive.setRapid(Plotter::rapid, Plotter::rapid);
+};
+
+/**
+ * Fastest step of a line drawn after a drawing speed limit record
+ * @param  start Start speed, as sent
+ * @param  speed Cruise speed, as sent
+ * @param  accel Acceleration, as sent
+ * @param  bad   Set to the record being turned down
+ * @return       Fastest step (steps/s)
+ */
+static double record(int start, int speed, int accel, bool &bad) {
+    ShapeTable table;
+    table.add(SHAPE_FEED, 3);
+    table.set(0, start);
+    table.set(1, speed);
+    table.set(2, accel);
+
+    uart.flush();
+    Sim::sent().clear();
+    table.draw(false);
+    uart.flush();
+    bad = Sim::sent().find("Bad speed limits") != std::string::npos;
+
+    Sim::steps().clear();
+    POS at = Plotter::position();
+    drive.lineTo(at.x + 8000, at.y);
+    drive.sync();
+
+    double fastest, slowest;
+    speeds(0, Sim::steps().size(), fastest, slowest);
+    return fastest;
+};
+
+/**
+ * Speed limit records (F and R) under 1 are turned down, the drawing speed
+ * stays as it was. Faster than the steppers go is held at PROFILE_MAX_SPEED
+ * and PROFILE_MAX_ACCEL.
+ */
+static void records() {
+    const int bad[][3] = {
+        { 100, -1, 1000 },  // Would be 65535 steps/s
+        { 100, 600, -1000 },
+        { 0, 600, 1000 },
+        { -5, 600, 1000 },
+        { 100, 50, 1000 },  // Cruise under the start
+        { 100, 600, 0 }
+    };
+    bool turned;
+
+    for(size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        double fastest = record(bad[i][0], bad[i][1], bad[i][2], turned);
+        CHECK(turned);
+        CHECK(fastest <= Plotter::feed.speed * 1.01);
+    }
+
+    double fastest = record(100, 30000, 30000, turned);
+    printf("  records: F(100,30000,30000) up to %.0f steps/s\n", fastest);
+    CHECK(!turned);
+    CHECK(fastest <= PROFILE_MAX_SPEED * 1.01);
+    CHECK(fastest >= PROFILE_MAX_SPEED * 0.99);
+
+    fastest = record(Plotter::feed.start, Plotter::feed.speed, Plotter::feed.accel, turned);
+    CHECK(!turned);
+    CHECK(fastest <= Plotter::feed.speed * 1.01);
+};
+
+int main() {
+    Plotter::attach();
+    uart.begin(115200);
+
+    cruise();
+    mixed();
+    slow();
+    records();
+
+    return Check::done("RapidTest");
+};
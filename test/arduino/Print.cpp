@@ -0,0 +1,68 @@
+/**
+ *  Print.cpp
+ *
+ *  Host stand-in for the Arduino core's Print, text out through write().
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include "Print.h"
+#include <stdio.h>
+
+/**
+ * Write a buffer
+ * @param  buffer Bytes
+ * @param  size   Number of bytes
+ * @return        Bytes written
+ */
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while(size--) n += write(*buffer++);
+    return n;
+};
+
+/**
+ * Print a number
+ * @param  n        Magnitude
+ * @param  negative Print a '-' first
+ * @param  base     Base (2-16)
+ * @return          Bytes written
+ */
+size_t Print::number(unsigned long n, bool negative, int base) {
+    char buf[8 * sizeof(long) + 2];
+    char *at = &buf[sizeof(buf) - 1];
+    *at = '\0';
+
+    if(base < 2) base = DEC;
+    do {
+        *--at = "0123456789ABCDEF"[n % base];
+        n /= base;
+    } while(n > 0);
+    if(negative) *--at = '-';
+
+    return write(at);
+};
+
+/**
+ * Print a signed number, only base 10 is signed
+ * @param  n    Number
+ * @param  base Base (2-16)
+ * @return      Bytes written
+ */
+size_t Print::print(long n, int base) {
+    if(base == DEC && n < 0) return number(-(unsigned long)n, true, base);
+    return number((unsigned long)n, false, base);
+};
+
+/**
+ * Print a number with a set number of decimals
+ * @param  n      Number
+ * @param  digits Decimals
+ * @return        Bytes written
+ */
+size_t Print::print(double n, int digits) {
+    char buf[40];
+    snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return write(buf);
+};
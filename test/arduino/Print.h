@@ -0,0 +1,59 @@
+/**
+ *  Print.h
+ *
+ *  Host stand-in for the Arduino core's Print, text out through write().
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef PRINT_H
+#define PRINT_H
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DEC 10
+#define HEX 16
+
+// Text kept in flash, a plain string here (WString.h in the core)
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+/**
+ * Prints text and numbers a byte at a time
+ */
+class Print {
+private:
+    /**
+     * Print a number
+     * @param  n        Magnitude
+     * @param  negative Print a '-' first
+     * @param  base     Base (2-16)
+     * @return          Bytes written
+     */
+    size_t number(unsigned long n, bool negative, int base);
+
+public:
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *s){ return s == NULL ? 0 : write((const uint8_t *)s, strlen(s)); };
+    virtual int availableForWrite(){ return 0; };
+    virtual void flush(){};
+
+    size_t print(const char *s){ return write(s); };
+    size_t print(const __FlashStringHelper *s){ return write((const char *)s); };
+    size_t print(char c){ return write((uint8_t)c); };
+    size_t print(unsigned char n, int base = DEC){ return print((unsigned long)n, base); };
+    size_t print(int n, int base = DEC){ return print((long)n, base); };
+    size_t print(unsigned int n, int base = DEC){ return print((unsigned long)n, base); };
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC){ return number(n, false, base); };
+    size_t print(double n, int digits = 2);
+
+    size_t println(){ return write("\r\n"); };
+    template<typename T> size_t println(T v){ return print(v) + println(); };
+    template<typename T> size_t println(T v, int f){ return print(v, f) + println(); };
+};
+
+#endif
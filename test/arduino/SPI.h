@@ -0,0 +1,34 @@
+/**
+ *  SPI.h
+ *
+ *  Host stand-in for the Arduino SPI library. A transfer takes the time the
+ *  8MHz bus would (ShiftedLCD uses it).
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef SPI_H
+#define SPI_H
+#include <stdint.h>
+
+#define SPI_CLOCK_DIV2 0x04
+#define SPI_MODE0      0x00
+#define LSBFIRST       0
+#define MSBFIRST       1
+
+/**
+ * SPI bus
+ */
+class SPIClass {
+public:
+    void begin(){};
+    void setClockDivider(uint8_t){};
+    void setDataMode(uint8_t){};
+    void setBitOrder(uint8_t){};
+    uint8_t transfer(uint8_t data);
+};
+
+extern SPIClass SPI;
+
+#endif
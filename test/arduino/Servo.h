@@ -0,0 +1,28 @@
+/**
+ *  Servo.h
+ *
+ *  Host stand-in for the Arduino Servo library, the angle last written is
+ *  kept by the simulated Uno (Sim::servo()).
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef SERVO_H
+#define SERVO_H
+#include <stdint.h>
+
+/**
+ * Hobby servo on a pin
+ */
+class Servo {
+private:
+    int _angle = -1; // Angle last written, -1 before the first write
+
+public:
+    uint8_t attach(int pin);
+    void write(int angle);
+    int read(){ return _angle; };
+};
+
+#endif
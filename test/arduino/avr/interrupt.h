@@ -0,0 +1,22 @@
+/**
+ *  avr/interrupt.h
+ *
+ *  Host stand-in for avr-libc's interrupt.h. An ISR is a plain function the
+ *  simulated Uno calls (sim/Sim.cpp).
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef AVR_INTERRUPT_H
+#define AVR_INTERRUPT_H
+
+#define ISR(vector) extern "C" void vector(void)
+
+void interrupts();
+void noInterrupts();
+
+inline void sei(){ interrupts(); }
+inline void cli(){ noInterrupts(); }
+
+#endif
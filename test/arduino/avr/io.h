@@ -0,0 +1,102 @@
+/**
+ *  avr/io.h
+ *
+ *  Host stand-in for avr-libc's io.h, the ATmega328P registers the firmware
+ *  uses. Most are plain bytes. Registers with side effects (status flags that
+ *  are polled, data registers) are Registers, reading or writing one runs the
+ *  simulated peripheral (sim/Sim.cpp).
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef AVR_IO_H
+#define AVR_IO_H
+#include <stdint.h>
+
+#define _BV(bit) (1 << (bit))
+
+/**
+ * I/O register with side effects
+ */
+class Register {
+public:
+    typedef uint8_t (*Get)(Register &reg);
+    typedef void (*Set)(Register &reg, uint8_t value);
+
+    uint8_t value; // Bits as stored
+    Get get;       // Runs on a read, returns the bits read
+    Set set;       // Runs on a write, stores the bits
+
+    /**
+     * Register with its read and write handlers
+     * @param get   Read handler, NULL reads value
+     * @param set   Write handler, NULL stores value
+     * @param value Bits at reset
+     */
+    constexpr Register(Get get, Set set, uint8_t value): value(value), get(get), set(set) {};
+
+    operator uint8_t(){ return get ? get(*this) : value; };
+
+    Register &operator=(uint8_t v){
+        if(set) set(*this, v);
+        else value = v;
+        return *this;
+    };
+
+    Register &operator|=(uint8_t v){ return *this = (uint8_t)(*this | v); };
+    Register &operator&=(uint8_t v){ return *this = (uint8_t)(*this & v); };
+};
+
+// Status register
+extern Register SREG;
+#define SREG_I 7
+
+// Stack pointer, in a fake RAM on the host (sim/Sim.cpp)
+extern volatile uintptr_t SP;
+
+// Ports
+extern volatile uint8_t PORTB, PORTC, PORTD;
+extern volatile uint8_t DDRB, DDRC, DDRD;
+extern volatile uint8_t PINB, PINC, PIND;
+
+// Timer2
+extern volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B, TIMSK2, TIFR2;
+#define WGM21  1
+#define CS20   0
+#define CS21   1
+#define CS22   2
+#define OCIE2A 1
+#define OCF2A  1
+
+// ADC
+extern volatile uint8_t ADMUX, ADCSRB, DIDR0;
+extern Register ADCSRA;
+extern volatile uint16_t ADC;
+#define REFS0 6
+#define ADEN  7
+#define ADSC  6
+#define ADATE 5
+#define ADIF  4
+#define ADIE  3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+
+// USART0
+extern Register UCSR0A, UDR0;
+extern volatile uint8_t UCSR0B, UCSR0C;
+extern volatile uint16_t UBRR0;
+#define RXC0   7
+#define TXC0   6
+#define UDRE0  5
+#define DOR0   3
+#define U2X0   1
+#define RXCIE0 7
+#define UDRIE0 5
+#define RXEN0  4
+#define TXEN0  3
+#define UCSZ01 2
+#define UCSZ00 1
+
+#endif
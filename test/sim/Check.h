@@ -0,0 +1,56 @@
+/**
+ *  Check.h
+ *
+ *  Checks for the host tests. A failed check prints where it is and what
+ *  failed, the test carries on. Return Check::done() from main(), it is the
+ *  exit status make sees.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef CHECK_H
+#define CHECK_H
+#include <stdio.h>
+
+// Check a condition, printing it if it fails
+#define CHECK(cond) Check::that((cond), #cond, __FILE__, __LINE__)
+
+/**
+ * Counts the checks and the ones that failed
+ */
+class Check {
+private:
+    static int &checks(){ static int n = 0; return n; };
+    static int &failed(){ static int n = 0; return n; };
+
+public:
+    /**
+     * Check a condition
+     * @param  ok   Condition held
+     * @param  what Condition (text)
+     * @param  file File it is in
+     * @param  line Line it is on
+     * @return      ok
+     */
+    static bool that(bool ok, const char *what, const char *file, int line){
+        checks()++;
+        if(!ok) {
+            failed()++;
+            printf("%s:%d: failed: %s\n", file, line, what);
+        }
+        return ok;
+    };
+
+    /**
+     * Print the count and give the exit status
+     * @param  name Name of the test
+     * @return      0 if every check held, 1 if not
+     */
+    static int done(const char *name){
+        printf("%s: %d checks, %d failed\n", name, checks(), failed());
+        return failed() > 0 ? 1 : 0;
+    };
+};
+
+#endif
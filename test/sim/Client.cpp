@@ -0,0 +1,327 @@
+/**
+ *  Client.cpp
+ *
+ *  client.js on the other end of the simulated USART, the Sender run in node
+ *  (Client.js) in lockstep with the Sim, or client.js on a pty (Pty.js) in
+ *  real time.
+ *
+ *  @author Drew Sommer
+ *  @version 1.2.0
+ *  @license MIT (https://mit-license.org)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pty.h>
+#include <termios.h>
+#include <time.h>
+#include "Client.h"
+#include "Sim.h"
+#include "Link.h"
+#include "Telemetry.h"
+
+// Scripts, from test/ (where make runs the tests)
+#define CLIENT_SCRIPT "sim/Client.js" // The Sender in lockstep
+#define CLIENT_PTY    "sim/Pty.js"    // client.js on a pty
+
+static std::vector<std::string> _list; // Command list
+static bool _binary = false;           // Send frames
+static unsigned long _latency = 0;     // Time before a reply arrives (us)
+static unsigned long _baud = 0;        // Baud to ask for, 0 for none
+static bool _asked = false;            // Baud asked for
+static size_t _next = 0;               // Next token to send (text)
+
+static std::vector<std::string> _lines; // Lines from the plotter
+static std::string _line;               // Line coming in
+static int _skip = 0;                   // Telemetry bytes left to take out
+
+static unsigned long _listed = 0;  // Whole list sent (us)
+static unsigned long _bytes = 0;   // Bytes sent
+static unsigned long _frames = 0;  // Frames sent
+static unsigned long _timer = 0;   // Sender's resend timer runs out (us), 0 if not running
+static unsigned long _lose = 0;    // Every nth frame is lost, 0 for none
+
+static FILE *_toNode = NULL;   // Lines to the Sender
+static FILE *_fromNode = NULL; // Its replies
+
+static int _pty = -1;        // Master side of the pty, -1 when answering here
+static std::string _out;     // Bytes from the plotter not yet written to it
+static unsigned long _wall;  // Wall clock when the Sim's time was 0 (us)
+
+/**
+ * Send bytes to the plotter, after the latency
+ * @param bytes Bytes
+ */
+static void send(const std::string &bytes) {
+    Sim::send(bytes.data(), bytes.size(), _latency);
+    _bytes += bytes.size();
+};
+
+/**
+ * Wall clock
+ * @return Time (us)
+ */
+static unsigned long wall() {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000UL + t.tv_nsec / 1000;
+};
+
+/**
+ * Start node, and give it the command list
+ * @param args   Script and its arguments
+ * @param window Keep frames in flight up to the credit
+ * @param reply  Take what it prints (lockstep), or leave it on ours
+ */
+static void spawn(const std::vector<std::string> &args, bool window, bool reply) {
+    int in[2], out[2];
+    if(pipe2(in, O_CLOEXEC) != 0 || pipe2(out, O_CLOEXEC) != 0) {
+        perror("pipe");
+        exit(2);
+    }
+
+    if(fork() == 0) {
+        std::vector<char *> argv(1, (char *)"node");
+        for(size_t i = 0; i < args.size(); i++) argv.push_back((char *)args[i].c_str());
+        argv.push_back(NULL);
+
+        dup2(in[0], 0);
+        if(reply) dup2(out[1], 1);
+        execvp("node", &argv[0]);
+        perror("node");
+        _exit(2);
+    }
+
+    close(in[0]);
+    close(out[1]);
+    _toNode = fdopen(in[1], "w");
+    _fromNode = fdopen(out[0], "r");
+
+    fprintf(_toNode, "%s", window ? "" : "stop ");
+    for(size_t i = 0; i < _list.size(); i++) {
+        fprintf(_toNode, "%s%s", i > 0 ? " " : "", _list[i].c_str());
+    }
+    fprintf(_toNode, "\n");
+    fflush(_toNode);
+};
+
+/**
+ * Hand a line to the Sender and send the frames it writes
+ * @param line Line from the plotter (or #timeout)
+ */
+static void sender(const std::string &line) {
+    fprintf(_toNode, "%s\n", line.c_str());
+    fflush(_toNode);
+
+    char buf[1024];
+    while(fgets(buf, sizeof(buf), _fromNode) != NULL) {
+        std::string reply(buf);
+        while(!reply.empty() && (reply[reply.size() - 1] == '\n' || reply[reply.size() - 1] == '\r')) {
+            reply.erase(reply.size() - 1);
+        }
+
+        if(reply == ".") return;
+        if(reply.compare(0, 6, "armed ") == 0) {
+            _timer = Sim::now() + 1000UL * strtoul(reply.c_str() + 6, NULL, 10);
+        } else if(reply == "stopped") {
+            _timer = 0;
+        } else if(reply == "done") {
+            if(_listed == 0) _listed = Sim::now();
+        } else {
+            std::string frame;
+            for(size_t i = 0; i + 1 < reply.size(); i += 2) {
+                frame.push_back((char)strtol(reply.substr(i, 2).c_str(), NULL, 16));
+            }
+            _frames++;
+            if(_lose == 0 || _frames % _lose != 0) send(frame);
+        }
+    }
+
+    fprintf(stderr, "Client: node stopped\n");
+    exit(2);
+};
+
+/**
+ * A whole line from the plotter, answer it
+ * @param line Line
+ */
+static void answer(const std::string &line) {
+    _lines.push_back(line);
+    if(_pty >= 0) return;
+
+    if(line == ";Ready;" && _baud != 0 && !_asked) {
+        char ask[32];
+        snprintf(ask, sizeof(ask), "b%lu;", _baud);
+        send(ask);
+        _asked = true;
+    } else if(line == ";Ready;") {
+        send("n");
+    }
+
+    if(_binary && (line == ";next;" || line == ";wait;" || line.compare(0, 5, ";ack ") == 0 || line.compare(0, 5, ";nak ") == 0)) {
+        sender(line);
+    }
+
+    if(!_binary && line == ";next;" && _next < _list.size()) {
+        send(_list[_next++]);
+        if(_next == _list.size()) _listed = Sim::now();
+    }
+};
+
+/**
+ * A byte from the plotter
+ * @param byte Byte
+ */
+static void received(uint8_t byte) {
+    if(_pty >= 0) _out.push_back((char)byte);
+
+    // Telemetry, not text
+    if(_skip > 0) {
+        _skip--;
+        return;
+    }
+    if(byte == TELEMETRY_START) {
+        _skip = TELEMETRY_FRAME - 1;
+        return;
+    }
+
+    if(byte == '\n') {
+        answer(_line);
+        _line.clear();
+    } else if(byte != '\r') {
+        _line.push_back((char)byte);
+    }
+};
+
+/**
+ * Start answering the plotter (sets Sim::onSent). Call once.
+ * @param list    Command list, as SVG_Parser makes it
+ * @param binary  Send frames (client.js's binary), or text
+ * @param window  Keep frames in flight up to the credit, or send one at a
+ *                time (stop and wait)
+ * @param latency Time before a reply starts arriving (us)
+ * @param baud    Baud to ask for in the handshake, 0 to stay at 9600
+ */
+void Client::start(const std::vector<std::string> &list, bool binary, bool window, unsigned long latency, unsigned long baud) {
+    _list = list;
+    _binary = binary;
+    _latency = latency;
+    _baud = baud;
+
+    if(binary) spawn(std::vector<std::string>(1, CLIENT_SCRIPT), window, true);
+    Sim::onSent = received;
+};
+
+/**
+ * Put the USART on a pty, with client.js in node on the other side sending
+ * frames in real time (sets Sim::onSent). The Sim is held to the wall clock
+ * from here on. Call once, instead of start().
+ * @param list    Command list, as SVG_Parser makes it
+ * @param window  Keep frames in flight up to the credit, or send one at a
+ *                time (stop and wait)
+ * @param latency Time before a reply starts arriving (us)
+ * @param baud    Baud to ask for in the handshake, 0 to stay at 9600
+ */
+void Client::startPty(const std::vector<std::string> &list, bool window, unsigned long latency, unsigned long baud) {
+    int slave;
+    char name[64];
+    if(openpty(&_pty, &slave, name, NULL, NULL) != 0) {
+        perror("openpty");
+        exit(2);
+    }
+
+    // Bytes as they are, no line editing or echo. The slave is held open so
+    // the master never reads an end while node is starting.
+    termios raw;
+    tcgetattr(slave, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(slave, TCSANOW, &raw);
+    fcntl(_pty, F_SETFL, O_NONBLOCK);
+    fcntl(_pty, F_SETFD, FD_CLOEXEC);
+    fcntl(slave, F_SETFD, FD_CLOEXEC);
+
+    char ms[24], rate[24];
+    snprintf(ms, sizeof(ms), "%lu", latency / 1000);
+    snprintf(rate, sizeof(rate), "%lu", baud);
+    const char *args[] = { CLIENT_PTY, name, ms, rate };
+
+    _list = list;
+    _binary = true;
+    spawn(std::vector<std::string>(args, args + 4), window, false);
+
+    _wall = wall() - Sim::now();
+    Sim::onSent = received;
+};
+
+/**
+ * Lose every nth frame the Sender writes (not on a pty)
+ * @param n Frames, 0 to lose none
+ */
+void Client::lose(unsigned long n) {
+    _lose = n;
+};
+
+/**
+ * Call every millisecond (from Sim::onMillis), runs the Sender's timer, and
+ * the pty
+ */
+void Client::tick() {
+    if(_timer != 0 && Sim::now() >= _timer) {
+        _timer = 0;
+        sender("#timeout");
+    }
+
+    if(_pty < 0) return;
+
+    // The plotter's bytes out to the pty, and what came back in to it
+    ssize_t n = _out.empty() ? 0 : write(_pty, _out.data(), _out.size());
+    if(n > 0) _out.erase(0, n);
+
+    char buf[256];
+    while((n = read(_pty, buf, sizeof(buf))) > 0) {
+        Sim::send(buf, n, 0);
+        _bytes += n;
+        _listed = Sim::now();
+        for(ssize_t i = 0; i < n; i++) {
+            if((uint8_t)buf[i] == LINK_START) _frames++;
+        }
+    }
+
+    // Keep to the wall clock, node's latency and timers run on it
+    unsigned long now = wall() - _wall;
+    if(now < Sim::now()) usleep(Sim::now() - now);
+};
+
+/**
+ * Lines the plotter has sent, telemetry taken out
+ * @return Lines
+ */
+std::vector<std::string> &Client::lines() {
+    return _lines;
+};
+
+/**
+ * Time the whole list was sent: the last token written, every frame acked,
+ * or on a pty the last byte in
+ * @return Time (us), 0 if not yet
+ */
+unsigned long Client::listed() {
+    return _listed;
+};
+
+/**
+ * Bytes sent to the plotter
+ * @return Bytes
+ */
+unsigned long Client::bytes() {
+    return _bytes;
+};
+
+/**
+ * Frames the Sender has written, sent again ones included
+ * @return Frames
+ */
+unsigned long Client::frames() {
+    return _frames;
+};
@@ -0,0 +1,101 @@
+/**
+ *  Client.h
+ *
+ *  client.js on the other end of the simulated USART, for running main.cpp
+ *  on the Sim. It answers the lines the plotter sends as client.js does:
+ *
+ *    ;Ready;    b<baud>; the first time if a baud is set, then n
+ *    ;next;     the next token of the command list (text protocol), or
+ *               with frames, start sending them
+ *    ;ack ..;   ;nak ..; ;wait; are passed to the Sender
+ *
+ *  Frames are sent by client/Link.js's own Sender, run in node (Client.js)
+ *  in lockstep with the Sim: each line is handed to it and the frames it
+ *  writes are sent right away, its resend timer runs on the Sim's time.
+ *  Everything sent starts arriving after the latency (the host and USB
+ *  turning a reply around), then comes in at the USART's baud. Frames may
+ *  be lost on the way, as a line dropping their start would lose them.
+ *
+ *  Or the USART is put on a pty and client.js's link is run on the other side
+ *  (Pty.js), with its own timers and the latency put in by node, in real
+ *  time. The Sim is held to the wall clock for it.
+ *
+ *  Telemetry frames are taken out of what the plotter sends, as client.js
+ *  does, the rest is kept as lines.
+ *
+ *  @author Drew Sommer
+ *  @version 1.2.0
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef CLIENT_H
+#define CLIENT_H
+#include <vector>
+#include <string>
+
+/**
+ * The simulated client, all static (there is only one port)
+ */
+class Client {
+public:
+    /**
+     * Start answering the plotter (sets Sim::onSent). Call once.
+     * @param list    Command list, as SVG_Parser makes it
+     * @param binary  Send frames (client.js's binary), or text
+     * @param window  Keep frames in flight up to the credit, or send one
+     *                at a time (stop and wait)
+     * @param latency Time before a reply starts arriving (us)
+     * @param baud    Baud to ask for in the handshake, 0 to stay at 9600
+     */
+    static void start(const std::vector<std::string> &list, bool binary, bool window, unsigned long latency, unsigned long baud);
+
+    /**
+     * Put the USART on a pty, with client.js in node on the other side
+     * sending frames in real time (sets Sim::onSent). The Sim is held to the
+     * wall clock from here on. Call once, instead of start().
+     * @param list    Command list, as SVG_Parser makes it
+     * @param window  Keep frames in flight up to the credit, or send one at
+     *                a time (stop and wait)
+     * @param latency Time before a reply starts arriving (us)
+     * @param baud    Baud to ask for in the handshake, 0 to stay at 9600
+     */
+    static void startPty(const std::vector<std::string> &list, bool window, unsigned long latency, unsigned long baud);
+
+    /**
+     * Lose every nth frame the Sender writes (not on a pty)
+     * @param n Frames, 0 to lose none
+     */
+    static void lose(unsigned long n);
+
+    /**
+     * Call every millisecond (from Sim::onMillis), runs the Sender's timer,
+     * and the pty
+     */
+    static void tick();
+
+    /**
+     * Lines the plotter has sent, telemetry taken out
+     * @return Lines
+     */
+    static std::vector<std::string> &lines();
+
+    /**
+     * Time the whole list was sent: the last token written, every frame
+     * acked, or on a pty the last byte in
+     * @return Time (us), 0 if not yet
+     */
+    static unsigned long listed();
+
+    /**
+     * Bytes sent to the plotter
+     * @return Bytes
+     */
+    static unsigned long bytes();
+
+    /**
+     * Frames the Sender has written, sent again ones included
+     * @return Frames
+     */
+    static unsigned long frames();
+};
+
+#endif
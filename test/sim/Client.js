@@ -0,0 +1,77 @@
+/**
+ *  Client.js
+ *
+ *  client/Link.js's Sender for the simulated client (see Client.h), run in
+ *  lockstep with the Sim. Each line on stdin is one from the plotter, the
+ *  reply is the frames the Sender writes for it (hex, a line each), then
+ *  'armed <ms>' if it started its resend timer or 'stopped' if it stopped
+ *  it, 'done' once every frame is acked, and '.' to end the reply. The Sim
+ *  keeps the time, so the timer is only noted here, the Sim sends '#timeout'
+ *  when it runs out.
+ *
+ *  The first line is the command list, its tokens separated by spaces, with
+ *  'stop' before them to send one frame at a time (stop and wait).
+ *
+ *  @author Drew Sommer
+ *  @version 1.1.0
+ *  @license MIT (https://mit-license.org)
+ */
+const path     = require('path'),
+      readline = require('readline'),
+      Link     = require(path.join(__dirname, '../../client/Link'));
+
+var list   = null,  // Command list
+    stop   = false, // One frame at a time
+    sender = null,  // Link.Sender, from the first ;next;
+    out    = [];    // Reply to this line
+
+// The Sender's timer, on the Sim's time
+global.setTimeout = (fn, ms) => {
+    out.push('armed ' + ms);
+    return 1;
+};
+global.clearTimeout = (timer) => {
+    if(timer != null) out.push('stopped');
+};
+
+const lines = readline.createInterface({ input: process.stdin });
+
+lines.on('line', (line) => {
+    var reply;
+
+    // The command list comes first
+    if(list == null) {
+        list = line.split(' ');
+        stop = list[0] == 'stop';
+        if(stop) list.shift();
+        return;
+    }
+
+    // Connected, start sending frames (as client.js)
+    if(line == ';next;' && !sender) {
+        sender = new Link.Sender(Link.encode(list), (frame) => out.push(frame.toString('hex')));
+
+        // Never acked past the first frame, so never more than one in flight
+        if(stop) Object.defineProperty(sender, 'acked', { get: () => false, set: () => {} });
+
+        sender.fill();
+
+    } else if(sender && line == '#timeout') {
+        sender.resend();
+
+    } else if(sender && (reply = /^;ack (\d+) (\d+);$/.exec(line))) {
+        sender.ack(+reply[1], +reply[2]);
+
+    } else if(sender && (reply = /^;nak (\d+);$/.exec(line))) {
+        sender.nak(+reply[1]);
+
+    } else if(sender && line == ';wait;') {
+        sender.wait();
+    }
+
+    if(sender && sender.done()) out.push('done');
+    out.push('.');
+
+    process.stdout.write(out.join('\n') + '\n');
+    out = [];
+});
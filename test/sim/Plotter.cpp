@@ -0,0 +1,167 @@
+/**
+ *  Plotter.cpp
+ *
+ *  The plotter as main.cpp builds it on the simulated Uno.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#include <math.h>
+#include "Plotter.h"
+#include "shapes/Shape.h"
+#include "Pins.h"
+
+//                    stp         dir        en            x  x-   x+  buff flip
+static PinMap pinsX = { X_STEP_PIN, X_DIR_PIN, X_ENABLE_PIN, 0, 340, 510, 50, 1 };
+static PinMap pinsY = { Y_STEP_PIN, Y_DIR_PIN, Y_ENABLE_PIN, 1, 340, 510, 50, 0 };
+
+LiquidCrystal Plotter::lcd(9);
+Drive Plotter::drive(pinsX, pinsY, 5, 10, 0, 71, &Plotter::lcd);
+
+// Limit switches, positions the axes close them at
+static long origins = 0;
+static long fars = 0;
+static bool switches = false;
+
+const Profile Plotter::feed = { 100, 600, 1000 };
+const Profile Plotter::rapid = { 100, 1000, 2000 };
+
+/**
+ * Set the analog pin of an axis's switches for where it is
+ * @param axis PLOTTER_X or PLOTTER_Y
+ */
+static void press(uint8_t axis) {
+    PinMap map = axis == PLOTTER_X ? pinsX : pinsY;
+    long pos = Sim::position(axis);
+
+    if(pos >= origins) Sim::analog(map.btnPin, map.btn2);
+    else if(pos <= fars) Sim::analog(map.btnPin, map.btn1);
+    else Sim::analog(map.btnPin, 0);
+};
+
+/**
+ * A step was taken, move the switches with it
+ * @param step Step
+ */
+static void stepped(const SimStep &step) {
+    if(switches) press(step.axis);
+};
+
+/**
+ * Set up like main.cpp's setup() (without the Uart), and watch the steppers
+ */
+void Plotter::attach() {
+
+    // forward() moves back along the axis, x is flipped (dir HIGH)
+    Sim::axis(PLOTTER_X, X_STEP_PIN, X_DIR_PIN, -1);
+    Sim::axis(PLOTTER_Y, Y_STEP_PIN, Y_DIR_PIN, 1);
+
+    lcd.begin(16, 2);
+    lcd.noCursor();
+
+    Sim::onStep = stepped;
+
+    drive.attach();
+    Shape::attach(&drive, &lcd);
+    drive.setProfile(feed, feed);
+    drive.setRapid(rapid, rapid);
+};
+
+/**
+ * Where the steppers are
+ * @return POS
+ */
+POS Plotter::position() {
+    return { (int)Sim::position(PLOTTER_X), (int)Sim::position(PLOTTER_Y) };
+};
+
+/**
+ * Put the limit switches of both axes at positions of the steppers (as
+ * position() has them, they are not reset by origin()). origin() homes
+ * backward, which steps up the axes, to the origin switch (btn2).
+ * @param origin Position from which the origin switch is closed
+ * @param far    Position from which the far switch is closed (btn1)
+ */
+void Plotter::limits(long origin, long far) {
+    origins = origin;
+    fars = far;
+    switches = true;
+    press(PLOTTER_X);
+    press(PLOTTER_Y);
+};
+
+/**
+ * Steps taken by an axis since the log was last cleared
+ * @param  axis PLOTTER_X or PLOTTER_Y
+ * @return      Steps
+ */
+unsigned long Plotter::steps(uint8_t axis) {
+    unsigned long n = 0;
+    for(size_t i = 0; i < Sim::steps().size(); i++) {
+        if(Sim::steps()[i].axis == axis) n++;
+    }
+    return n;
+};
+
+/**
+ * Replay the steps logged since it was last cleared, both axes of one tick
+ * taken together
+ * @param  x Position before the first step
+ * @param  y Position before the first step
+ * @return   Ticks
+ */
+std::vector<PlotterTick> Plotter::ticks(long x, long y) {
+    const std::vector<SimStep> &steps = Sim::steps();
+    std::vector<PlotterTick> ticks;
+
+    for(size_t i = 0; i < steps.size(); i++) {
+        if(steps[i].axis == PLOTTER_X) x += steps[i].dir;
+        else y += steps[i].dir;
+
+        // The other axis stepped in the same tick, take it too
+        if(i + 1 < steps.size() && steps[i + 1].us - steps[i].us < PLOTTER_TICK && steps[i + 1].axis != steps[i].axis) continue;
+
+        ticks.push_back({ steps[i].us, x, y });
+    }
+    return ticks;
+};
+
+/**
+ * Distance from a point to a curve, from the closest of points spaced along
+ * it and then narrowed down (the distance is smooth around it)
+ * @param  curve Curve
+ * @param  n     Points spaced along it
+ * @param  x     Point
+ * @param  y     Point
+ * @return       Distance
+ */
+double Plotter::distance(const PlotterCurve &curve, int n, double x, double y) {
+    double best = 1e9;
+    double at = 0;
+    double cx, cy;
+
+    for(int i = 0; i <= n; i++) {
+        curve((double)i / n, cx, cy);
+        double d = hypot(cx - x, cy - y);
+        if(d < best) {
+            best = d;
+            at = (double)i / n;
+        }
+    }
+
+    double lo = fmax(0, at - 1.0 / n);
+    double hi = fmin(1, at + 1.0 / n);
+    for(int i = 0; i < 60; i++) {
+        double m1 = lo + (hi - lo) / 3;
+        double m2 = hi - (hi - lo) / 3;
+        double x1, y1, x2, y2;
+        curve(m1, x1, y1);
+        curve(m2, x2, y2);
+        if(hypot(x1 - x, y1 - y) < hypot(x2 - x, y2 - y)) hi = m2;
+        else lo = m1;
+    }
+
+    curve((lo + hi) / 2, cx, cy);
+    return fmin(best, hypot(cx - x, cy - y));
+};
@@ -0,0 +1,103 @@
+/**
+ *  Plotter.h
+ *
+ *  The plotter as main.cpp builds it (same pins, Drive and profiles) on the
+ *  simulated Uno, with the step pins of both steppers watched. Positions are
+ *  in the Drive's coordinates. The steps logged are replayed tick by tick,
+ *  and points checked against the curve they should be on.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef PLOTTER_H
+#define PLOTTER_H
+#include <functional>
+#include <vector>
+#include "Sim.h"
+#include "Drive.h"
+#include "lib/ShiftedLCD.h"
+
+// Axes watched by the Sim
+#define PLOTTER_X 0
+#define PLOTTER_Y 1
+
+// Steps of both axes closer than this are of one tick of the ISR (us)
+#define PLOTTER_TICK 100
+
+/**
+ * A tick of the stepper ISR, where it left the pen
+ */
+struct PlotterTick {
+    unsigned long us; // Time of its last step (us)
+    long x;           // Position after it
+    long y;           // Position after it
+};
+
+/**
+ * A curve, the point at t from 0 to 1
+ */
+typedef std::function<void(double t, double &x, double &y)> PlotterCurve;
+
+/**
+ * The plotter of main.cpp, all static (the Drive is a singleton)
+ */
+class Plotter {
+public:
+    static LiquidCrystal lcd; // LCD screen
+    static Drive drive;       // Drive, as main.cpp sets it up
+
+    // main.cpp's profiles
+    static const Profile feed;  // Drawing (lineTo)
+    static const Profile rapid; // Pen up (moveTo)
+
+    /**
+     * Set up like main.cpp's setup() (without the Uart), and watch the
+     * steppers
+     */
+    static void attach();
+
+    /**
+     * Where the steppers are
+     * @return POS
+     */
+    static POS position();
+
+    /**
+     * Put the limit switches of both axes at positions of the steppers (as
+     * position() has them, they are not reset by origin()). origin() homes
+     * backward, which steps up the axes, to the origin switch (btn2).
+     * @param origin Position from which the origin switch is closed
+     * @param far    Position from which the far switch is closed (btn1)
+     */
+    static void limits(long origin, long far);
+
+    /**
+     * Steps taken by an axis since the log was last cleared
+     * @param  axis PLOTTER_X or PLOTTER_Y
+     * @return      Steps
+     */
+    static unsigned long steps(uint8_t axis);
+
+    /**
+     * Replay the steps logged since it was last cleared, both axes of one
+     * tick taken together
+     * @param  x Position before the first step
+     * @param  y Position before the first step
+     * @return   Ticks
+     */
+    static std::vector<PlotterTick> ticks(long x, long y);
+
+    /**
+     * Distance from a point to a curve, from the closest of points spaced
+     * along it and then narrowed down (the distance is smooth around it)
+     * @param  curve Curve
+     * @param  n     Points spaced along it
+     * @param  x     Point
+     * @param  y     Point
+     * @return       Distance
+     */
+    static double distance(const PlotterCurve &curve, int n, double x, double y);
+};
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ *  Pty.js
+ *
+ *  client.js on the pty the simulated plotter's USART is put on (see
+ *  Client.h), in real time. Lines are answered as client.js answers them,
+ *  frames are sent by client/Link.js's Sender on its own timers, and
+ *  everything written waits the latency first (the host and USB turning a
+ *  reply around). The port is the pty itself, serialport is not needed.
+ *
+ *      node sim/Pty.js <tty> <latency ms> <baud>
+ *
+ *  The command list comes on stdin first, one line of tokens separated by
+ *  spaces, with 'stop' before them to send one frame at a time (stop and
+ *  wait). Exits once the plotter is done.
+ *
+ *  @author Drew Sommer
+ *  @version 1.1.0
+ *  @license MIT (https://mit-license.org)
+ */
+const fs        = require('fs'),
+      path      = require('path'),
+      readline  = require('readline'),
+      Link      = require(path.join(__dirname, '../../client/Link')),
+      Telemetry = require(path.join(__dirname, '../../client/Telemetry'));
+
+var tty     = process.argv[2],
+    latency = +process.argv[3],
+    baud    = +process.argv[4],
+    asked   = false,
+    sender  = null;
+
+/**
+ * Write to the plotter once the latency has passed
+ * @param {Number}        fd   The pty
+ * @param {Buffer|String} data Bytes
+ */
+function write(fd, data) {
+    setTimeout(() => fs.writeSync(fd, data), latency);
+}
+
+/**
+ * Answer the plotter over the pty
+ * @param {Array} list Command list, 'stop' first for one frame at a time
+ */
+function connect(list) {
+    var stop = list[0] == 'stop',
+        fd   = fs.openSync(tty, fs.constants.O_RDWR | fs.constants.O_NOCTTY),
+        text = '',
+        telemetry = new Telemetry(() => {});
+
+    if(stop) list.shift();
+
+    fs.createReadStream(null, { fd: fd, highWaterMark: 64 }).on('data', (data) => {
+        text += telemetry.push(data);
+
+        var lines = text.split(/\r\n|\r|\n/);
+        text = lines.pop();
+
+        for(var line of lines) {
+            var reply;
+
+            if(line == ';Ready;' && baud && !asked) {
+                write(fd, 'b' + baud + ';');
+                asked = true;
+            } else if(line == ';Ready;') {
+                write(fd, 'n');
+            }
+
+            if(line == ';next;' && !sender) {
+                sender = new Link.Sender(Link.encode(list), (frame) => write(fd, frame));
+
+                // Never acked past the first frame, so never more than one
+                // in flight
+                if(stop) Object.defineProperty(sender, 'acked', { get: () => false, set: () => {} });
+
+                sender.fill();
+            } else if(sender && (reply = /^;ack (\d+) (\d+);$/.exec(line))) {
+                sender.ack(+reply[1], +reply[2]);
+            } else if(sender && (reply = /^;nak (\d+);$/.exec(line))) {
+                sender.nak(+reply[1]);
+            } else if(sender && line == ';wait;') {
+                sender.wait();
+            }
+
+            if(line == 'Done!') process.exit(0);
+        }
+    }).on('error', () => process.exit(1));
+}
+
+readline.createInterface({ input: process.stdin }).once('line', (line) => connect(line.split(' ')));
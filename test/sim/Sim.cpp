@@ -0,0 +1,492 @@
+/**
+ *  Sim.cpp
+ *
+ *  Simulated Uno the firmware runs on in the host tests: the core functions,
+ *  the registers and the peripherals behind them.
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.3
+ *  @license MIT (https://mit-license.org)
+ */
+#include <deque>
+#include <utility>
+#include "Sim.h"
+#include <Arduino.h>
+#include <Servo.h>
+#include <SPI.h>
+
+// Interrupt vectors, in priority order
+extern "C" void TIMER2_COMPA_vect(void);
+extern "C" void USART_RX_vect(void);
+extern "C" void USART_UDRE_vect(void);
+extern "C" void ADC_vect(void);
+
+static unsigned long _us = 0;         // Time (us)
+static bool _running = false;         // Inside run(), time is being counted
+static unsigned long _owed = 0;       // Time passed while inside run()
+static int _pins[20];                 // Digital pin levels
+static int _analog[8];                // Analog pin readings
+static int _servo = -1;               // Servo angle
+static unsigned long _servoTime = 0;  // Servo last written (us)
+
+// Watched axes
+static int _step[SIM_AXES] = { -1, -1 };
+static int _dir[SIM_AXES];
+static int8_t _high[SIM_AXES];
+static long _position[SIM_AXES];
+static std::vector<SimStep> _steps;
+void (*Sim::onStep)(const SimStep &step) = NULL;
+
+// ADC
+static bool _converting = false;     // Conversion running
+static unsigned long _converted = 0; // Time it is done (us)
+
+// USART, receive
+static std::deque<std::pair<unsigned long, uint8_t> > _rxWire; // Arrival (us), byte
+static uint8_t _rxData = 0;          // Byte in UDR0
+static bool _rxFull = false;         // UDR0 holds a byte not yet read (RXC0)
+static bool _overrun = false;        // A byte was lost before UDR0 was read (DOR0)
+static unsigned long _overruns = 0;
+
+// USART, send
+static std::deque<std::pair<unsigned long, uint8_t> > _txWire; // Sent out (us), byte
+static unsigned long _shifted = 0;   // Time the byte shifting out is done (us)
+static unsigned long _emptied = 0;   // Time UDR0 is free for another byte (us)
+static unsigned long _txcCleared = 0; // Time TXC0 was last cleared (us)
+static std::string _sent;
+void (*Sim::onSent)(uint8_t byte) = NULL;
+
+// Test's own timing
+void (*Sim::onMillis)() = NULL;
+
+// Registers
+static uint8_t getPolled(Register &reg);
+static uint8_t getUCSR0A(Register &reg);
+static void setUCSR0A(Register &reg, uint8_t value);
+static uint8_t getUDR0(Register &reg);
+static void setUDR0(Register &reg, uint8_t value);
+static void setADCSRA(Register &reg, uint8_t value);
+
+Register SREG(getPolled, NULL, _BV(SREG_I)); // The core enables interrupts before setup()
+volatile uint8_t PORTB, PORTC, PORTD;
+volatile uint8_t DDRB, DDRC, DDRD;
+volatile uint8_t PINB, PINC, PIND;
+volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B, TIMSK2, TIFR2;
+volatile uint8_t ADMUX, ADCSRB, DIDR0;
+Register ADCSRA(getPolled, setADCSRA, _BV(ADEN) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0)); // The core's init() enables it, /128
+volatile uint16_t ADC;
+Register UCSR0A(getUCSR0A, setUCSR0A, 0);
+Register UDR0(getUDR0, setUDR0, 0);
+volatile uint8_t UCSR0B, UCSR0C;
+volatile uint16_t UBRR0;
+
+// RAM between the heap and the stack, as avr-libc marks it (the host stack
+// is elsewhere, so this stays painted: Stack only has something to measure)
+static uint8_t ram[512];
+char __heap_start;
+char *__brkval = (char *)ram;
+volatile uintptr_t SP = (uintptr_t)(ram + sizeof(ram));
+
+SPIClass SPI;
+
+/**
+ * Time a byte takes on the wire at the USART's baud (10 bits)
+ * @return Time (us)
+ */
+static unsigned long byteUs() {
+    unsigned long clocks = (UCSR0A.value & _BV(U2X0) ? 8UL : 16UL) * (UBRR0 + 1);
+    return 10 * clocks / (F_CPU / 1000000UL);
+};
+
+/**
+ * Run the interrupts that are flagged, while they are enabled
+ */
+static void service() {
+    while(SREG.value & _BV(SREG_I)) {
+        void (*vector)(void) = NULL;
+
+        if((TIFR2 & _BV(OCF2A)) && (TIMSK2 & _BV(OCIE2A))) {
+            TIFR2 &= ~_BV(OCF2A);
+            vector = TIMER2_COMPA_vect;
+        } else if(_rxFull && (UCSR0B & _BV(RXCIE0))) {
+            vector = USART_RX_vect;
+        } else if(_us >= _emptied && (UCSR0B & _BV(UDRIE0))) {
+            vector = USART_UDRE_vect;
+        } else if((ADCSRA.value & _BV(ADIF)) && (ADCSRA.value & _BV(ADIE))) {
+            ADCSRA.value &= ~_BV(ADIF);
+            vector = ADC_vect;
+        }
+        if(vector == NULL) return;
+
+        SREG.value &= ~_BV(SREG_I);
+        vector();
+        SREG.value |= _BV(SREG_I);
+    }
+};
+
+/**
+ * One microsecond of the peripherals
+ */
+static void step() {
+    _us++;
+
+    // Timer2, /32 prescaler, CTC on OCR2A
+    if((TCCR2B & (_BV(CS22) | _BV(CS21) | _BV(CS20))) && !(_us & 1)) {
+        if(TCNT2 == OCR2A) {
+            TCNT2 = 0;
+            TIFR2 |= _BV(OCF2A);
+        } else {
+            TCNT2++;
+        }
+    }
+
+    // Conversion done
+    if(_converting && _us >= _converted) {
+        _converting = false;
+        ADC = _analog[ADMUX & 0x07];
+        ADCSRA.value = (ADCSRA.value & ~_BV(ADSC)) | _BV(ADIF);
+    }
+
+    // Bytes in
+    while(!_rxWire.empty() && _rxWire.front().first <= _us) {
+        uint8_t data = _rxWire.front().second;
+        _rxWire.pop_front();
+        if(!(UCSR0B & _BV(RXEN0))) continue;
+
+        if(_rxFull) {
+            _overrun = true;
+            _overruns++;
+        } else {
+            _rxData = data;
+            _rxFull = true;
+        }
+    }
+
+    // Bytes out
+    while(!_txWire.empty() && _txWire.front().first <= _us) {
+        uint8_t data = _txWire.front().second;
+        _txWire.pop_front();
+        _sent.push_back((char)data);
+        if(Sim::onSent != NULL) Sim::onSent(data);
+    }
+
+    if(Sim::onMillis != NULL && _us % 1000 == 0) Sim::onMillis();
+};
+
+/**
+ * Let time pass, running the peripherals and interrupts
+ * @param us Time (us)
+ */
+void Sim::run(unsigned long us) {
+
+    // Called from inside run() (an interrupt waiting, a status register read
+    // while running one), the time is counted once we are back out
+    if(_running) {
+        _owed += us;
+        return;
+    }
+
+    _running = true;
+    while(us > 0 || _owed > 0) {
+        if(us > 0) us--;
+        else _owed--;
+
+        step();
+        _running = false;
+        service();
+        _running = true;
+    }
+    _running = false;
+};
+
+/**
+ * Time since start
+ * @return Time (us)
+ */
+unsigned long Sim::now() {
+    return _us + _owed;
+};
+
+/**
+ * Read of a polled register, takes time so busy loops on it get somewhere
+ */
+static uint8_t getPolled(Register &reg) {
+    Sim::run(SIM_POLL_US);
+    return reg.value;
+};
+
+/**
+ * ADCSRA written, starts a conversion on ADSC, ADIF is cleared by a 1
+ */
+static void setADCSRA(Register &reg, uint8_t value) {
+    uint8_t flag = reg.value & _BV(ADIF);
+    if(value & _BV(ADIF)) flag = 0;
+
+    bool start = (value & _BV(ADSC)) && (value & _BV(ADEN)) && !_converting;
+    reg.value = (value & ~_BV(ADIF)) | flag;
+
+    if(start) {
+        _converting = true;
+        _converted = Sim::now() + SIM_ADC_US;
+    }
+};
+
+/**
+ * UCSR0A read, the flags from the state of the USART
+ */
+static uint8_t getUCSR0A(Register &reg) {
+    Sim::run(SIM_POLL_US);
+    unsigned long now = Sim::now();
+
+    uint8_t value = reg.value & _BV(U2X0);
+    if(_rxFull) value |= _BV(RXC0);
+    if(now >= _shifted && _shifted > _txcCleared) value |= _BV(TXC0);
+    if(now >= _emptied) value |= _BV(UDRE0);
+    if(_overrun) value |= _BV(DOR0);
+    return value;
+};
+
+/**
+ * UCSR0A written, keeps U2X0, TXC0 is cleared by a 1
+ */
+static void setUCSR0A(Register &reg, uint8_t value) {
+    reg.value = value & _BV(U2X0);
+    if(value & _BV(TXC0)) _txcCleared = Sim::now();
+};
+
+/**
+ * UDR0 read, the byte received
+ */
+static uint8_t getUDR0(Register &) {
+    _rxFull = false;
+    _overrun = false;
+    return _rxData;
+};
+
+/**
+ * UDR0 written, sends the byte once the one shifting out is done
+ */
+static void setUDR0(Register &, uint8_t value) {
+    if(!(UCSR0B & _BV(TXEN0))) return;
+
+    unsigned long now = Sim::now();
+    if(now < _emptied) return; // Still full, the byte is lost
+
+    if(now >= _shifted) {
+        _emptied = now;
+        _shifted = now + byteUs();
+    } else {
+        _emptied = _shifted;
+        _shifted += byteUs();
+    }
+    _txWire.push_back(std::make_pair(_shifted, value));
+};
+
+/**
+ * Level of a digital pin
+ * @param  pin Pin
+ * @return     HIGH/LOW
+ */
+int Sim::pin(uint8_t pin) {
+    return pin < 20 ? _pins[pin] : LOW;
+};
+
+/**
+ * Set the voltage on an analog pin
+ * @param channel Analog pin (0-7)
+ * @param value   Reading (0-1023)
+ */
+void Sim::analog(uint8_t channel, int value) {
+    _analog[channel & 0x07] = value;
+};
+
+/**
+ * Angle last written to the servo
+ * @return Angle (0-180), -1 if none
+ */
+int Sim::servo() {
+    return _servo;
+};
+
+/**
+ * Time the servo was last written
+ * @return Time (us)
+ */
+unsigned long Sim::servoTime() {
+    return _servoTime;
+};
+
+/**
+ * Watch the step pin of an axis
+ * @param axis Axis (0 - SIM_AXES-1)
+ * @param step Step pin
+ * @param dir  Dir pin
+ * @param high Direction of a step with the dir pin HIGH (1 or -1)
+ */
+void Sim::axis(uint8_t axis, uint8_t step, uint8_t dir, int8_t high) {
+    _step[axis] = step;
+    _dir[axis] = dir;
+    _high[axis] = high;
+};
+
+/**
+ * Position of an axis, its steps added up
+ * @param  axis Axis
+ * @return      Position (steps)
+ */
+long Sim::position(uint8_t axis) {
+    return _position[axis];
+};
+
+/**
+ * Set the position of an axis (where it is put by hand)
+ * @param axis Axis
+ * @param pos  Position (steps)
+ */
+void Sim::setPosition(uint8_t axis, long pos) {
+    _position[axis] = pos;
+};
+
+/**
+ * Every step taken since the log was last cleared
+ * @return Steps
+ */
+std::vector<SimStep> &Sim::steps() {
+    return _steps;
+};
+
+/**
+ * Send bytes to the USART at its baud, they arrive once the ones sent before
+ * them have
+ * @param bytes Bytes
+ * @param n     Number of bytes
+ * @param delay Time before the first starts arriving (us)
+ */
+void Sim::send(const void *bytes, size_t n, unsigned long delay) {
+    unsigned long at = now() + delay;
+    if(!_rxWire.empty() && _rxWire.back().first > at) at = _rxWire.back().first;
+
+    const uint8_t *b = (const uint8_t *)bytes;
+    for(size_t i = 0; i < n; i++) {
+        at += byteUs();
+        _rxWire.push_back(std::make_pair(at, b[i]));
+    }
+};
+
+/**
+ * Bytes still on their way to the USART
+ * @return Bytes
+ */
+size_t Sim::sending() {
+    return _rxWire.size();
+};
+
+/**
+ * Bytes the USART has sent out, cleared by the test
+ * @return Bytes
+ */
+std::string &Sim::sent() {
+    return _sent;
+};
+
+/**
+ * Baud the USART is set to
+ * @return Baud, 0 when off
+ */
+unsigned long Sim::baud() {
+    if(!(UCSR0B & (_BV(RXEN0) | _BV(TXEN0)))) return 0;
+    return 10000000UL / byteUs();
+};
+
+/**
+ * Bytes lost to an overrun of UDR0
+ * @return Bytes
+ */
+unsigned long Sim::overruns() {
+    return _overruns;
+};
+
+// ---- Arduino core
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    Sim::run(SIM_CALL_US);
+    if(pin >= 20) return;
+
+    bool rising = value && !_pins[pin];
+    _pins[pin] = value ? HIGH : LOW;
+    if(!rising) return;
+
+    for(uint8_t axis = 0; axis < SIM_AXES; axis++) {
+        if(_step[axis] != pin) continue;
+
+        SimStep step = { Sim::now(), axis, (int8_t)(_pins[_dir[axis]] ? _high[axis] : -_high[axis]) };
+        _position[axis] += step.dir;
+        _steps.push_back(step);
+        if(Sim::onStep != NULL) Sim::onStep(step);
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    Sim::run(SIM_CALL_US);
+    return Sim::pin(pin);
+}
+
+int analogRead(uint8_t pin) {
+    if(pin >= A0) pin -= A0;
+
+    ADMUX = _BV(REFS0) | (pin & 0x07);
+    ADCSRA |= _BV(ADSC);
+    while(ADCSRA & _BV(ADSC));
+
+    return ADC;
+}
+
+unsigned long millis() {
+    Sim::run(SIM_CALL_US);
+    return Sim::now() / 1000;
+}
+
+unsigned long micros() {
+    Sim::run(SIM_CALL_US);
+    return Sim::now();
+}
+
+void delay(unsigned long ms) {
+    Sim::run(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    Sim::run(us);
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+void interrupts() {
+    SREG.value |= _BV(SREG_I);
+    if(!_running) service();
+}
+
+void noInterrupts() {
+    SREG.value &= ~_BV(SREG_I);
+}
+
+// ---- Libraries
+
+uint8_t Servo::attach(int) {
+    return 0;
+}
+
+void Servo::write(int angle) {
+    _angle = angle;
+    _servo = angle;
+    _servoTime = Sim::now();
+}
+
+uint8_t SPIClass::transfer(uint8_t) {
+    Sim::run(2);
+    return 0;
+}
@@ -0,0 +1,186 @@
+/**
+ *  Sim.h
+ *
+ *  Simulated Uno the firmware runs on in the host tests. Time is counted in
+ *  microseconds and only moves when the firmware waits (delay(), busy loops
+ *  on a status register ..) or a test calls run(). As it moves the simulated
+ *  peripherals run and their interrupts are called, like the real chip:
+ *
+ *    Timer2  counts 2us ticks (the /32 prescaler), clears on OCR2A and
+ *            flags compare A, keeps counting while an interrupt runs
+ *    ADC     a conversion takes 104us (the /128 prescaler), started by ADSC
+ *    USART0  bytes take 10 bits at the baud in UBRR0, one byte in UDR0 and
+ *            one shifting each way, received bytes overrun if UDR0 is not
+ *            read in time
+ *
+ *  Interrupts run when flagged, in vector order, while SREG's I bit is set
+ *  (cleared while one runs). Reading a polled status register takes
+ *  SIM_POLL_US, other calls into the core SIM_CALL_US.
+ *
+ *  Step pins of the axes are watched, every step is logged with the time and
+ *  direction (from the dir pin), giving the position the steppers really
+ *  moved to.
+ *
+ *  A test can act on the Sim's time from onMillis, called every millisecond
+ *  (a client's timeouts, a time limit).
+ *
+ *  @author Drew Sommer
+ *  @version 1.0.1
+ *  @license MIT (https://mit-license.org)
+ */
+#ifndef SIM_H
+#define SIM_H
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <string>
+
+// Time a read of a polled status register takes (us)
+#define SIM_POLL_US 1
+
+// Time a call into the core takes, digitalWrite(), millis() .. (us)
+#define SIM_CALL_US 4
+
+// Time an ADC conversion takes (us)
+#define SIM_ADC_US 104
+
+// Axes that can be watched
+#define SIM_AXES 2
+
+/**
+ * A step taken by an axis
+ */
+struct SimStep {
+    unsigned long us; // Time of the step (us)
+    uint8_t axis;     // Axis that stepped
+    int8_t dir;       // 1 or -1
+};
+
+/**
+ * The simulated Uno, all static (there is only one)
+ */
+class Sim {
+public:
+    /**
+     * Let time pass, running the peripherals and interrupts
+     * @param us Time (us)
+     */
+    static void run(unsigned long us);
+
+    /**
+     * Time since start
+     * @return Time (us)
+     */
+    static unsigned long now();
+
+    /**
+     * Level of a digital pin
+     * @param  pin Pin
+     * @return     HIGH/LOW
+     */
+    static int pin(uint8_t pin);
+
+    /**
+     * Set the voltage on an analog pin
+     * @param channel Analog pin (0-7)
+     * @param value   Reading (0-1023)
+     */
+    static void analog(uint8_t channel, int value);
+
+    /**
+     * Angle last written to the servo
+     * @return Angle (0-180), -1 if none
+     */
+    static int servo();
+
+    /**
+     * Time the servo was last written
+     * @return Time (us)
+     */
+    static unsigned long servoTime();
+
+    /**
+     * Watch the step pin of an axis
+     * @param axis Axis (0 - SIM_AXES-1)
+     * @param step Step pin
+     * @param dir  Dir pin
+     * @param high Direction of a step with the dir pin HIGH (1 or -1)
+     */
+    static void axis(uint8_t axis, uint8_t step, uint8_t dir, int8_t high);
+
+    /**
+     * Position of an axis, its steps added up
+     * @param  axis Axis
+     * @return      Position (steps)
+     */
+    static long position(uint8_t axis);
+
+    /**
+     * Set the position of an axis (where it is put by hand)
+     * @param axis Axis
+     * @param pos  Position (steps)
+     */
+    static void setPosition(uint8_t axis, long pos);
+
+    /**
+     * Every step taken since the log was last cleared
+     * @return Steps
+     */
+    static std::vector<SimStep> &steps();
+
+    /**
+     * Called after each step, to move the switches with the axes
+     */
+    static void (*onStep)(const SimStep &step);
+
+    /**
+     * Send bytes to the USART at its baud, they arrive once the ones sent
+     * before them have
+     * @param bytes Bytes
+     * @param n     Number of bytes
+     * @param delay Time before the first starts arriving (us)
+     */
+    static void send(const void *bytes, size_t n, unsigned long delay);
+
+    /**
+     * Send text to the USART at its baud
+     * @param text Text
+     */
+    static void send(const std::string &text){ send(text.data(), text.size(), 0); };
+
+    /**
+     * Bytes still on their way to the USART
+     * @return Bytes
+     */
+    static size_t sending();
+
+    /**
+     * Bytes the USART has sent out, cleared by the test
+     * @return Bytes
+     */
+    static std::string &sent();
+
+    /**
+     * Called as each byte finishes going out of the USART
+     */
+    static void (*onSent)(uint8_t byte);
+
+    /**
+     * Baud the USART is set to
+     * @return Baud, 0 when off
+     */
+    static unsigned long baud();
+
+    /**
+     * Bytes lost to an overrun of UDR0
+     * @return Bytes
+     */
+    static unsigned long overruns();
+
+    /**
+     * Called every millisecond
+     */
+    static void (*onMillis)();
+};
+
+#endif